@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace FinalProject {
+
+/**
+ * Node allocators, used as the `Alloc` template parameter of the lists.
+ * An allocator is a stateless type with
+ *   static auto Allocate(uint64_t size) -> void *;
+ *   static void Deallocate(void *ptr, uint64_t size);
+ * `Deallocate` has the signature of EpochHandler::Deleter, so retired nodes go straight back to their allocator.
+ * A block is aligned to the largest power of two dividing its size, up to MAX_ALIGNMENT. sizeof(T) is a multiple
+ *  of alignof(T), so the lists only have to check alignof(Node) <= MAX_ALIGNMENT
+ */
+struct MallocAllocator {
+  static constexpr uint64_t MAX_ALIGNMENT = 64;
+
+  static auto Allocate(uint64_t size) -> void *;
+  static void Deallocate(void *ptr, uint64_t size);
+};
+
+/**
+ * Size-class pool: blocks up to MAX_POOLED_SIZE are rounded up to SIZE_CLASS bytes and recycled
+ *  through a per-thread free list, bigger requests go to malloc.
+ * A thread cache which grows past CACHE_LIMIT blocks hands half of them to a shared list,
+ *  so that a thread which mostly frees (e.g. the background reclaimer) does not hoard memory.
+ * Chunks are never returned to the OS
+ */
+struct PoolAllocator {
+  static constexpr uint64_t MAX_ALIGNMENT   = MallocAllocator::MAX_ALIGNMENT;  // of the chunks, blocks inherit it
+  static constexpr uint64_t SIZE_CLASS      = 16;
+  static constexpr uint64_t MAX_POOLED_SIZE = 512;
+  static constexpr uint64_t NO_SIZE_CLASSES = MAX_POOLED_SIZE / SIZE_CLASS;
+  static constexpr uint64_t CACHE_LIMIT     = 1024;
+  static constexpr uint64_t CHUNK_SIZE      = 64 * 1024;
+
+  static auto Allocate(uint64_t size) -> void *;
+  static void Deallocate(void *ptr, uint64_t size);
+};
+
+}  // namespace FinalProject
\ No newline at end of file
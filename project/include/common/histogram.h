@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+namespace FinalProject {
+
+/**
+ * Log-linear latency histogram in the spirit of HdrHistogram: values below 2 * SUB_BUCKETS are exact,
+ *  above that every power of two is split into SUB_BUCKETS buckets, i.e. a relative error of at most
+ *  1/SUB_BUCKETS (3.125%) over the whole uint64_t range.
+ * Recording is a bucket computation and an increment, not thread-safe: keep one histogram per thread
+ *  and Merge() them once the threads are done
+ */
+class LatencyHistogram {
+ public:
+  static constexpr uint32_t SUB_BUCKET_BITS = 5;
+  static constexpr uint64_t SUB_BUCKETS     = 1 << SUB_BUCKET_BITS;
+  static constexpr uint32_t NO_BUCKETS      = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  void Record(uint64_t value) {
+    counts_[BucketOf(value)]++;
+    if (value > max_) { max_ = value; }
+  }
+  /* Add `count` values at once to `bucket`, the maximum becomes at least the bucket's upper bound */
+  void RecordBucket(uint32_t bucket, uint64_t count);
+  void Merge(const LatencyHistogram &other);
+  void Reset();
+
+  auto Count() const -> uint64_t;
+  auto Max() const -> uint64_t { return max_; }
+  auto BucketCount(uint32_t bucket) const -> uint64_t { return counts_[bucket]; }
+  /* Smallest bucket upper bound below which a `quantile` (in [0, 1]) of the values fall, capped at Max() */
+  auto Percentile(double quantile) const -> uint64_t;
+  /* "p50 <v> p99 <v> p99.9 <v> max <v>" */
+  void Print(std::ostream &out) const;
+
+  static auto BucketOf(uint64_t value) -> uint32_t {
+    if (value < SUB_BUCKETS) { return value; }
+    auto shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + (value >> shift) - SUB_BUCKETS;
+  }
+  static auto UpperBound(uint32_t bucket) -> uint64_t;
+
+ private:
+  std::array<uint64_t, NO_BUCKETS> counts_{};
+  uint64_t max_{0};
+};
+
+}  // namespace FinalProject
\ No newline at end of file
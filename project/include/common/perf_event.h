@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+namespace FinalProject {
+
+/**
+ * Hardware counters of the whole process over a measured phase, read through perf_event_open(2).
+ * Counters are opened with `inherit`, so threads spawned after StartCounters() are counted too.
+ * Where perf is unavailable (non-Linux, perf_event_paranoid, containers), Available() is false
+ *  and every counter reads as NaN, the wall-clock time is still measured
+ */
+class PerfEvent {
+ public:
+  enum Event : uint32_t { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, NO_EVENTS };
+
+  PerfEvent();
+  ~PerfEvent();
+  PerfEvent(const PerfEvent &)                     = delete;
+  auto operator=(const PerfEvent &) -> PerfEvent & = delete;
+
+  void StartCounters();
+  void StopCounters();
+
+  auto Available() const -> bool;
+  /* Counter value over the last phase, scaled up when the kernel multiplexed it. NaN if not available */
+  auto Value(Event event) const -> double;
+  auto Seconds() const -> double { return seconds_; }
+
+  static auto Name(Event event) -> const char *;
+  /* "<name>: <value per op>" for every counter, `ops` = 1 gives the raw totals */
+  void PrintReport(std::ostream &out, uint64_t ops) const;
+
+ private:
+  std::array<int, NO_EVENTS> fds_;
+  std::array<double, NO_EVENTS> values_{};
+  uint64_t start_ns_{0};
+  double seconds_{0};
+};
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace FinalProject {
+
+/**
+ * Lower bound over a sorted array of keys, shared by the array-of-keys layouts (unrolled list chunks,
+ *  B+-tree nodes).
+ * Integral keys of 32 or 64 bits are searched with a vector kernel: a binary search narrows the range
+ *  to SIMD_BLOCK bytes, which are then compared against the key in a few instructions, and the
+ *  position is the number of keys smaller than it. Any other key type uses the scalar binary search.
+ * The instruction set is chosen at compile time (-march=native): AVX-512, AVX2, or the scalar fallback
+ */
+#if defined(__AVX512F__)
+inline constexpr const char *SIMD_ISA = "avx512";
+inline constexpr bool SIMD_ENABLED    = true;
+#elif defined(__AVX2__)
+inline constexpr const char *SIMD_ISA = "avx2";
+inline constexpr bool SIMD_ENABLED    = true;
+#else
+inline constexpr const char *SIMD_ISA = "scalar";
+inline constexpr bool SIMD_ENABLED    = false;
+#endif
+
+inline constexpr uint32_t SIMD_BLOCK = 128;  // Bytes left to the vector compare, two cache lines
+
+template <typename K>
+concept VectorKey = std::integral<K> && (sizeof(K) == 4 || sizeof(K) == 8);
+
+/* First position whose key is >= `key`, `count` if there is none */
+template <typename K>
+auto ScalarLowerBound(const K *keys, uint32_t count, const K &key) -> uint32_t {
+  uint32_t lower = 0;
+  uint32_t upper = count;
+  while (lower < upper) {
+    uint32_t mid = lower + (upper - lower) / 2;
+    if (keys[mid] <=> key < 0) {
+      lower = mid + 1;
+    } else {
+      upper = mid;
+    }
+  }
+  return lower;
+}
+
+/* Number of keys < `key` in keys[0, count), no ordering required */
+template <VectorKey K>
+auto CountLess(const K *keys, uint32_t count, K key) -> uint32_t {
+  uint32_t less = 0;
+  uint32_t idx  = 0;
+#if defined(__AVX512F__)
+  constexpr uint32_t LANES = 64 / sizeof(K);
+  if constexpr (sizeof(K) == 4) {
+    auto needle = _mm512_set1_epi32(static_cast<int32_t>(key));
+    for (; idx + LANES <= count; idx += LANES) {
+      auto block = _mm512_loadu_si512(keys + idx);
+      auto mask  = std::signed_integral<K> ? _mm512_cmplt_epi32_mask(block, needle)
+                                           : _mm512_cmplt_epu32_mask(block, needle);
+      less += std::popcount(static_cast<uint32_t>(mask));
+    }
+  } else {
+    auto needle = _mm512_set1_epi64(static_cast<int64_t>(key));
+    for (; idx + LANES <= count; idx += LANES) {
+      auto block = _mm512_loadu_si512(keys + idx);
+      auto mask  = std::signed_integral<K> ? _mm512_cmplt_epi64_mask(block, needle)
+                                           : _mm512_cmplt_epu64_mask(block, needle);
+      less += std::popcount(static_cast<uint32_t>(mask));
+    }
+  }
+#elif defined(__AVX2__)
+  // AVX2 only compares signed lanes: flipping the sign bit maps the unsigned order onto the signed one
+  constexpr uint32_t LANES = 32 / sizeof(K);
+  if constexpr (sizeof(K) == 4) {
+    auto flip   = _mm256_set1_epi32(std::signed_integral<K> ? 0 : INT32_MIN);
+    auto needle = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int32_t>(key)), flip);
+    for (; idx + LANES <= count; idx += LANES) {
+      auto block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + idx)), flip);
+      auto mask  = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, block)));
+      less += std::popcount(static_cast<uint32_t>(mask));
+    }
+  } else {
+    auto flip   = _mm256_set1_epi64x(std::signed_integral<K> ? 0 : INT64_MIN);
+    auto needle = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(key)), flip);
+    for (; idx + LANES <= count; idx += LANES) {
+      auto block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + idx)), flip);
+      auto mask  = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, block)));
+      less += std::popcount(static_cast<uint32_t>(mask));
+    }
+  }
+#endif
+  for (; idx < count; idx++) { less += keys[idx] < key; }
+  return less;
+}
+
+/* First position whose key is >= `key`, `count` if there is none. Without vector units, a plain binary search */
+template <typename K>
+auto KeyLowerBound(const K *keys, uint32_t count, const K &key) -> uint32_t {
+  if constexpr (VectorKey<K> && SIMD_ENABLED) {
+    constexpr uint32_t BLOCK = SIMD_BLOCK / sizeof(K);
+    uint32_t lower = 0;
+    uint32_t upper = count;
+    while (upper - lower > BLOCK) {
+      uint32_t mid = lower + (upper - lower) / 2;
+      if (keys[mid] < key) {
+        lower = mid + 1;
+      } else {
+        upper = mid;
+      }
+    }
+    return lower + CountLess(keys + lower, upper - lower, key);
+  } else {
+    return ScalarLowerBound(keys, count, key);
+  }
+}
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "common/histogram.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace FinalProject {
+
+/**
+ * Per-thread event counters, compiled in with -DFINAL_PROJECT_STATS (cmake -DENABLE_STATS=ON).
+ * When disabled, Stats::Add() is an empty inline function and every snapshot reads zero
+ */
+#ifdef FINAL_PROJECT_STATS
+inline constexpr bool STATS_ENABLED = true;
+#else
+inline constexpr bool STATS_ENABLED = false;
+#endif
+
+enum class Counter : uint32_t {
+  OPTIMISTIC_ATTEMPTS,     // optimistic guards taken
+  VALIDATION_FAILURES,     // failed optimistic validations, checks and upgrades, i.e. restarts
+  SHARED_ACQUISITIONS,     // shared guards taken
+  EXCLUSIVE_ACQUISITIONS,  // exclusive guards taken, including upgrades
+  SPIN_ITERATIONS,         // Waiter::Pause() calls
+  WAIT_NS,                 // time spent in contended acquisitions, spinning and parked
+  EPOCH_ADVANCES,          // global epoch increments
+  NODES_RECLAIMED,         // retired pointers actually freed, whatever the reclaimer
+  COUNT
+};
+
+/* Latency histograms, in nanoseconds */
+enum class Timer : uint32_t {
+  OPTIMISTIC_GUARD,  // lifetime of a guard per mode: acquisition, then critical section up to release/validation
+  SHARED_GUARD,
+  EXCLUSIVE_GUARD,
+  COUNT
+};
+
+/* Sum of every counter and histogram over all threads, alive or exited */
+struct StatsSnapshot {
+  std::array<uint64_t, static_cast<uint32_t>(Counter::COUNT)> values{};
+  std::array<LatencyHistogram, static_cast<uint32_t>(Timer::COUNT)> latencies{};
+
+  auto operator[](Counter counter) const -> uint64_t { return values[static_cast<uint32_t>(counter)]; }
+  auto operator[](Timer timer) const -> const LatencyHistogram & { return latencies[static_cast<uint32_t>(timer)]; }
+  /* Histograms are subtracted bucket by bucket, their maximum is then only known at bucket precision */
+  auto operator-(const StatsSnapshot &other) const -> StatsSnapshot;
+
+  static auto Name(Counter counter) -> const char *;
+  static auto Name(Timer timer) -> const char *;
+  /* One "<name> <value>" line per counter and one "<name> p50 ..." line per histogram, ready to be scraped */
+  void Print(std::ostream &out) const;
+};
+
+class Stats {
+ public:
+  static void Add(Counter counter, uint64_t value = 1) {
+    if constexpr (STATS_ENABLED) { AddLocal(static_cast<uint32_t>(counter), value); }
+  }
+  static void Record(Timer timer, uint64_t ns) {
+    if constexpr (STATS_ENABLED) { RecordLocal(static_cast<uint32_t>(timer), ns); }
+  }
+
+  static auto Snapshot() -> StatsSnapshot;
+  /* Best effort: increments racing with the reset may survive it */
+  static void Reset();
+
+ private:
+  static void AddLocal(uint32_t counter, uint64_t value);
+  static void RecordLocal(uint32_t timer, uint64_t ns);
+};
+
+inline auto NowNs() -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+/* Start time of a section timed into Stats, an empty member (with [[no_unique_address]]) when stats are disabled */
+struct StatsTimer {
+  void Start() {
+#ifdef FINAL_PROJECT_STATS
+    start_ns = NowNs();
+#endif
+  }
+  void Stop([[maybe_unused]] Timer timer) const {
+#ifdef FINAL_PROJECT_STATS
+    Stats::Record(timer, NowNs() - start_ns);
+#endif
+  }
+
+#ifdef FINAL_PROJECT_STATS
+  uint64_t start_ns{0};
+#endif
+};
+
+}  // namespace FinalProject
\ No newline at end of file
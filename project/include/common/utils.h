@@ -13,7 +13,13 @@ class RestartException {
   ~RestartException() = default;
 };
 
+/**
+ * Thread ids are dense and recycled: a thread takes the smallest free id on its first use of `thread_id`
+ *  (or on InitializeThread()), and gives it back when it exits
+ */
 void InitializeThread();
+auto AcquireThreadId() -> int;
+void ReleaseThreadId(int id);
 void HandleSegfault(int signo, siginfo_t *info, void *extra);
 void RegisterSegfaultHandler();
 
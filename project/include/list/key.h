@@ -0,0 +1,221 @@
+#pragma once
+
+#include "list/node.h"
+
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+namespace FinalProject {
+
+/**
+ * Node layouts of OptimisticSortedList, selected by its `KeyTrait` parameter. A trait provides
+ *   using Node;                                                  the node type
+ *   static auto Of(const T &value);                              the search key of `value`, computed once per operation
+ *   static auto Compare(const Node *node, key, const T &value);  order of `node` relative to `value`
+ *   static auto Value(const Node *node) -> const T &;
+ *   template <typename Alloc> static auto Make(void *memory, const T &value, Node *next) -> Node *;
+ *   template <typename Alloc> static void Destroy(Node *node);   any extra memory of the node comes from Alloc
+ *   static constexpr bool IMMUTABLE;                             updates replace the node instead of its value,
+ *                                                                needed unless T is trivially copyable (ValueSnapshot)
+ *   static void Prefetch(const Node *node);                      called on every node a traversal passes
+ *   class Window;                                                writer side of the prefetch hints, see JumpKey
+ */
+
+/**
+ * Private copy of a value read under an optimistic guard, handed to the caller only once the guard validated,
+ *  like the read side of a seqlock: a reader that loses a race never leaves a half-written value behind.
+ * Trivially copyable values are copied bytewise, a torn copy is just dropped. Any other value must come from an
+ *  IMMUTABLE layout, where a published node is never written again and stays alive until the reclaimer frees it
+ */
+template <typename T>
+class ValueSnapshot {
+ public:
+  void Copy(const T &value) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      std::memcpy(storage_.data, &value, sizeof(T));
+    } else {
+      storage_.emplace(value);
+    }
+  }
+  void Publish(T &out) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      std::memcpy(&out, storage_.data, sizeof(T));
+    } else {
+      out = std::move(*storage_);
+    }
+  }
+
+ private:
+  struct Bytes {
+    alignas(T) unsigned char data[sizeof(T)];
+  };
+
+  std::conditional_t<std::is_trivially_copyable_v<T>, Bytes, std::optional<T>> storage_;
+};
+
+/* Window of the layouts without prefetch hints, every call is a no-op */
+template <typename Node>
+class NoJumpWindow {
+ public:
+  void Push(Node *) {}
+  void AfterInsert(Node *) {}
+  void AfterDelete(Node *) {}
+  static void Rebuild(Node *) {}
+};
+
+/**
+ * Default layout: the value is stored inline and compared as a whole.
+ * Trivially copyable values are updated in place, any other value (e.g. one owning a std::string) gets a new node
+ */
+template <typename T>
+struct InlineKey {
+  using Node = FinalProject::Node<T>;
+
+  static constexpr bool IMMUTABLE = !std::is_trivially_copyable_v<T>;
+
+  static auto Of(const T &value) -> const T & { return value; }
+  static auto Compare(const Node *node, const T &key, const T &) { return node->value <=> key; }
+  static auto Value(const Node *node) -> const T & { return node->value; }
+  template <typename Alloc>
+  static auto Make(void *memory, const T &value, Node *next) -> Node * {
+    return new (memory) Node(value, next);
+  }
+  template <typename Alloc>
+  static void Destroy(Node *node) {
+    node->~Node();
+  }
+  static void Prefetch(const Node *) {}
+
+  using Window = NoJumpWindow<Node>;
+};
+
+/**
+ * Inline layout with software prefetching: every node also points DISTANCE nodes ahead, and a traversal prefetches
+ *  that node while it works on the current one, so that up to DISTANCE cache misses overlap instead of one per step.
+ * Jump pointers are hints: writers keep them exact under the exclusive lock (Window), readers never dereference them,
+ *  and prefetching a retired node is harmless
+ */
+template <typename T, uint32_t DISTANCE = 8>
+struct JumpKey {
+  using Node = JumpNode<T>;
+
+  static_assert(DISTANCE > 0, "Use InlineKey to disable prefetching");
+
+  static constexpr bool IMMUTABLE = !std::is_trivially_copyable_v<T>;  // As InlineKey
+
+  static auto Of(const T &value) -> const T & { return value; }
+  static auto Compare(const Node *node, const T &key, const T &) { return node->value <=> key; }
+  static auto Value(const Node *node) -> const T & { return node->value; }
+  template <typename Alloc>
+  static auto Make(void *memory, const T &value, Node *next) -> Node * {
+    return new (memory) Node(value, next);
+  }
+  template <typename Alloc>
+  static void Destroy(Node *node) {
+    node->~Node();
+  }
+  static void Prefetch(const Node *node) { __builtin_prefetch(node->jump); }
+
+  /**
+   * The last DISTANCE nodes passed by an exclusive walk, oldest first.
+   * A writer pushes every node in front of its modification, and once the list is changed the window walks on
+   *  until each of them (and an inserted node) points DISTANCE nodes ahead again, nullptr if there are not as many left
+   */
+  class Window {
+   public:
+    void Push(Node *node) {
+      if (size_ == DISTANCE) {
+        first_ = (first_ + 1) % DISTANCE;
+        size_--;
+      }
+      nodes_[(first_ + size_) % DISTANCE] = node;
+      size_++;
+    }
+    /* `node` was linked right behind the window */
+    void AfterInsert(Node *node) { Relink(node, size_ + 1); }
+    /* The node behind the window was unlinked, `next` took its place */
+    void AfterDelete(Node *next) { Relink(next, size_); }
+    /* Set every jump pointer of the list starting at `head`, after a batch of changes */
+    static void Rebuild(Node *head) { Window().Relink(head, UINT64_MAX); }
+
+   private:
+    /* Continue the walk at `node` until the `pending` oldest nodes of the window are relinked */
+    void Relink(Node *node, uint64_t pending) {
+      for (; pending > 0 && node != nullptr; node = node->next) {
+        if (size_ == DISTANCE) {
+          nodes_[first_]->jump = node;
+          pending--;
+        }
+        Push(node);
+      }
+      pending = std::min<uint64_t>(pending, size_);
+      for (uint64_t idx = 0; idx < pending; idx++) { nodes_[(first_ + idx) % DISTANCE]->jump = nullptr; }
+    }
+
+    Node *nodes_[DISTANCE];
+    uint32_t first_{0};
+    uint32_t size_{0};
+  };
+};
+
+/**
+ * Split layout for fat values: nodes hold `Extract{}(value)` and the next pointer, the value itself sits behind
+ *  a pointer, so a traversal only touches one small node per step.
+ * `Extract` is a stateless functor returning a small trivially copyable key which preserves the order of T.
+ * With `Exact`, equal keys mean equal values. Otherwise the key is a prefix, and ties are broken on the payload.
+ * The payload is allocated through the list's allocator, like the node
+ */
+template <typename T, typename Extract, bool Exact = true>
+struct SplitKey {
+  using Key  = std::remove_cvref_t<std::invoke_result_t<Extract, const T &>>;
+  using Node = SplitNode<Key, T>;
+
+  static_assert(std::is_trivially_copyable_v<Key>, "The key is copied into every node");
+
+  static constexpr bool IMMUTABLE = true;
+
+  static auto Of(const T &value) -> Key { return Extract{}(value); }
+  static auto Compare(const Node *node, const Key &key, const T &value) -> std::partial_ordering {
+    auto order = node->key <=> key;
+    if (Exact || order != 0) { return order; }
+    return *node->payload <=> value;
+  }
+  static auto Value(const Node *node) -> const T & { return *node->payload; }
+  template <typename Alloc>
+  static auto Make(void *memory, const T &value, Node *next) -> Node * {
+    auto payload = new (Alloc::Allocate(sizeof(T))) T(value);
+    return new (memory) Node(Of(value), payload, next);
+  }
+  template <typename Alloc>
+  static void Destroy(Node *node) {
+    node->payload->~T();
+    Alloc::Deallocate(node->payload, sizeof(T));
+    node->~Node();
+  }
+  static void Prefetch(const Node *) {}
+
+  using Window = NoJumpWindow<Node>;
+};
+
+/**
+ * First 8 bytes of a string, big-endian and zero-padded: compares like the string itself up to ties.
+ * Meant for SplitKey<std::string, StringPrefix, false>
+ */
+struct StringPrefix {
+  auto operator()(const std::string &value) const -> uint64_t {
+    uint64_t prefix = 0;
+    for (auto idx = 0U; idx < sizeof(prefix); idx++) {
+      auto byte = (idx < value.size()) ? static_cast<unsigned char>(value[idx]) : 0;
+      prefix    = (prefix << 8) | byte;
+    }
+    return prefix;
+  }
+};
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -1,53 +1,134 @@
 #pragma once
 
 #include "node.h"
+#include "list/key.h"
+#include "common/allocator.h"
 #include "sync/epoch.h"
 #include "sync/guard.h"
+#include "sync/wait.h"
 
+#include <concepts>
+#include <optional>
 #include <shared_mutex>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 namespace FinalProject {
  template <typename T>
 class SortedList {
  public:
   SortedList() = default;
+  virtual ~SortedList() = default;
   
-  auto NewNode(T value, Node<T> *next) -> Node<T> *;
   virtual void Insert(T value)             = 0;
   virtual auto LookUp(T value, T &result) -> bool = 0;
   virtual auto Delete(T value) -> bool                = 0;
+  /* Copy the values of [lo, hi) into `out` until it is full. Optional, throws std::logic_error if not supported */
+  virtual auto Scan(const T &, const T &, std::span<T>) -> uint64_t {
+    throw std::logic_error("Scan is not supported by this list");
+  }
 };
 
- template <typename T>
-class MutexSortedList : SortedList<T> {
+ template <typename T, typename Alloc = MallocAllocator>
+class MutexSortedList : public SortedList<T> {
  public:
+  static_assert(alignof(Node<T>) <= Alloc::MAX_ALIGNMENT, "Alloc cannot align the nodes");
+
   MutexSortedList() = default;
   ~MutexSortedList();
   void Insert(T value);
   auto LookUp(T value, T &result) -> bool;
   auto Delete(T value) -> bool;
+  auto Scan(const T &lo, const T &hi, std::span<T> out) -> uint64_t;
 
  private:
+  auto NewNode(T value, Node<T> *next) -> Node<T> *;
+  static void FreeNode(Node<T> *node);
+
   Node<T> *root_{nullptr};
   std::shared_mutex lock_;
 };
 
 /**
- * TODO: Your task is to implement the following
+ * Sorted list under a single HybridLock: readers traverse optimistically and validate once, writers lock exclusively.
+ * `KeyTrait` selects the node layout: InlineKey (the default), SplitKey for fat values,
+ *  or JumpKey to prefetch ahead on long lists, see list/key.h
+ * `Lock` guards the whole list: HybridLock, or ScalableHybridLock when readers often fall back to SHARED
  */
- template <typename T>
-class OptimisticSortedList : SortedList<T> {
+ template <typename T, typename Alloc = MallocAllocator, typename Reclaimer = EpochHandler,
+           typename KeyTrait = InlineKey<T>, typename Lock = HybridLock>
+class OptimisticSortedList : public SortedList<T> {
  public:
-  OptimisticSortedList(EpochHandler *ep);
+  using NodeType = typename KeyTrait::Node;  // Node<T>, SplitNode or JumpNode (list/key.h)
+  using Guard    = BasicHybridGuard<Lock>;
+
+  static_assert(std::is_trivially_copyable_v<T> || KeyTrait::IMMUTABLE,
+                "Optimistic readers copy values while writers update them, see ValueSnapshot");
+  static_assert(alignof(NodeType) <= Alloc::MAX_ALIGNMENT && alignof(T) <= Alloc::MAX_ALIGNMENT,
+                "Alloc cannot align the nodes or the split payloads");
+
+  static constexpr uint64_t SCAN_CHUNK = 64;  // Values validated and handed to the visitor at once
+
+  OptimisticSortedList(Reclaimer *reclaimer, const RestartPolicy &policy = RestartPolicy::Default());
   ~OptimisticSortedList();
   void Insert(T value);
   auto LookUp(T value, T &result) -> bool;
   auto Delete(T value) -> bool;
 
+  /* Batch interface, `keys[i]` is answered in `results[i]` and `found[i]`. Returns the number of keys found */
+  auto LookUpBatch(std::span<const T> keys, std::span<T> results, std::span<bool> found) -> uint64_t;
+  void InsertBatch(std::span<const T> values);
+  auto DeleteBatch(std::span<const T> values) -> uint64_t;
+
+  /* Range scan over [lo, hi). `visit(value)` returns false to stop early. Returns the number of visited values */
+  template <typename Fn>
+    requires std::predicate<Fn, const T &>
+  auto Scan(const T &lo, const T &hi, Fn &&visit) -> uint64_t;
+  auto Scan(const T &lo, const T &hi, std::span<T> out) -> uint64_t;
+
   private:
-  Node<T> *root_{nullptr};
-  HybridLock lock_;
-  EpochHandler *epoch_;
+  auto NewNode(const T &value, NodeType *next) -> NodeType *;
+  static void FreeNode(void *ptr, uint64_t size);
+  void Overwrite(NodeType *&link, const T &value);
+  static auto SortedOrder(std::span<const T> keys) -> std::vector<uint64_t>;
+  auto LookUpSorted(std::span<const T> keys, std::span<const uint64_t> order, std::span<T> results,
+                    std::span<bool> found, GuardMode mode) -> bool;
+
+  NodeType *root_{nullptr};
+  Lock lock_;
+  Reclaimer *reclaimer_;
+  // Bounds the optimistic attempts of the readers. Record() writes it, so it does not share a line with lock_
+  alignas(EpochHandler::CACHE_LINE_SIZE) RestartTracker restarts_;
+};
+
+/**
+ * Optimistic lock coupling: one HybridLock per node instead of one for the whole list.
+ * Readers hop from node to node optimistically, writers only lock the predecessor and the victim
+ */
+ template <typename T, typename Alloc = MallocAllocator, typename Reclaimer = EpochHandler>
+class LockCouplingSortedList : public SortedList<T> {
+ public:
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Insert overwrites values in place while optimistic readers copy them");
+  static_assert(alignof(LatchedNode<T>) <= Alloc::MAX_ALIGNMENT, "Alloc cannot align the nodes");
+
+  LockCouplingSortedList(Reclaimer *reclaimer);
+  ~LockCouplingSortedList();
+  void Insert(T value);
+  auto LookUp(T value, T &result) -> bool;
+  auto Delete(T value) -> bool;
+
+ private:
+  auto NewLatchedNode(T value, LatchedNode<T> *next) -> LatchedNode<T> *;
+  static void FreeLatchedNode(void *ptr, uint64_t size);
+  static auto Protect(typename Reclaimer::Guard &guard, uint64_t slot, LatchedNode<T> *node, HybridGuard &owner)
+      -> bool;
+
+  LatchedNode<T> *root_{nullptr};
+  HybridLock root_lock_;  // protects root_, acts as the predecessor of the first node
+  Reclaimer *reclaimer_;
 };
 
 }  // namespace FinalProject
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "list/list.h"
+#include "list/node.h"
+#include "common/allocator.h"
+#include "sync/epoch.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace FinalProject {
+
+/**
+ * Harris/Michael lock-free sorted list, non-blocking baseline for the HybridLock based lists.
+ * A node is deleted by marking its `next` pointer first (logical deletion) and then unlinking it
+ *  with a CAS on its predecessor. Whoever unlinks a node hands it to the EpochHandler
+ */
+template <typename T, typename Alloc = MallocAllocator>
+class LockFreeSortedList : public SortedList<T> {
+ public:
+  static_assert(alignof(LockFreeNode<T>) <= Alloc::MAX_ALIGNMENT, "Alloc cannot align the nodes");
+
+  LockFreeSortedList(EpochHandler *ep);
+  ~LockFreeSortedList();
+  void Insert(T value);
+  auto LookUp(T value, T &result) -> bool;
+  auto Delete(T value) -> bool;
+
+ private:
+  using NodePtr = LockFreeNode<T> *;
+
+  static auto IsMarked(NodePtr ptr) -> bool { return (reinterpret_cast<uintptr_t>(ptr) & 1) != 0; }
+
+  static auto Mark(NodePtr ptr) -> NodePtr { return reinterpret_cast<NodePtr>(reinterpret_cast<uintptr_t>(ptr) | 1); }
+
+  static auto Unmark(NodePtr ptr) -> NodePtr {
+    return reinterpret_cast<NodePtr>(reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(1));
+  }
+
+  auto NewLockFreeNode(T value, NodePtr next) -> NodePtr;
+  static void FreeLockFreeNode(void *ptr, uint64_t size);
+  auto Find(const T &value, std::atomic<NodePtr> *&prev, NodePtr &current) -> bool;
+
+  std::atomic<NodePtr> root_{nullptr};
+  EpochHandler *epoch_;
+};
+
+}  // namespace FinalProject
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "sync/lock.h"
+
+#include <atomic>
+#include <cstdint>
+
 namespace FinalProject {
 template <typename T>
 struct Node{
@@ -10,4 +15,87 @@ struct Node{
   ~Node() = default;
 };
 
+/**
+ * Node of the prefetching layout (see JumpKey in list/key.h): `jump` points a fixed number of nodes ahead.
+ * It is a prefetch hint only and never dereferenced
+ */
+template <typename T>
+struct JumpNode {
+  T value;
+  JumpNode *next;
+  JumpNode *jump{nullptr};
+
+  JumpNode(T value, JumpNode *next) : value(value), next(next) {}
+  ~JumpNode() = default;
+};
+
+/**
+ * Node of the split layout (see list/key.h): the comparison key and the link share the hot part of the node,
+ *  the value lives in its own allocation and is only dereferenced on a match.
+ * Both are immutable once the node is published, an update replaces the node
+ */
+template <typename Key, typename T>
+struct SplitNode {
+  Key key;
+  SplitNode *next;
+  T *payload;
+
+  SplitNode(Key key, T *payload, SplitNode *next) : key(key), next(next), payload(payload) {}
+  ~SplitNode() = default;
+};
+
+/**
+ * Chunk of the unrolled list: `count` sorted values, sized to fill CHUNK_SIZE bytes.
+ * The lock protects `count`, `values` and `next`
+ */
+template <typename T, uint64_t CHUNK_SIZE>
+struct UnrolledChunk {
+  static constexpr uint64_t MAX_ENTRIES =
+    (CHUNK_SIZE - sizeof(HybridLock) - sizeof(uint64_t) - sizeof(UnrolledChunk *)) / sizeof(T);
+
+  HybridLock lock;
+  uint32_t count{0};
+  UnrolledChunk *next{nullptr};
+  T values[MAX_ENTRIES];
+
+  UnrolledChunk() = default;
+  ~UnrolledChunk() = default;
+};
+
+/* Node of the lock coupling list: the lock protects `next` and `value` of this node */
+template <typename T>
+struct LatchedNode {
+  T value;
+  LatchedNode *next;
+  HybridLock lock;
+
+  LatchedNode(T value, LatchedNode *next) : value(value), next(next) {}
+  ~LatchedNode() = default;
+};
+
+/* Node of the lock-free list: the lowest bit of `next` marks this node as logically deleted */
+template <typename T>
+struct LockFreeNode {
+  T value;
+  std::atomic<LockFreeNode *> next;
+
+  LockFreeNode(T value, LockFreeNode *next) : value(value), next(next) {}
+  ~LockFreeNode() = default;
+};
+
+/**
+ * Tower of the skip list, allocated with room for `height` next pointers.
+ * The lock protects the value and every level of the tower
+ */
+template <typename T>
+struct SkipNode {
+  T value;
+  HybridLock lock;
+  uint8_t height;
+  SkipNode *next[];
+
+  SkipNode(T value, uint8_t height) : value(value), height(height) {}
+  ~SkipNode() = default;
+};
+
 }  // namespace FinalProject
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "list/list.h"
+#include "list/node.h"
+#include "common/allocator.h"
+#include "sync/epoch.h"
+#include "sync/lock.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace FinalProject {
+
+/**
+ * Skip list with one HybridLock per tower, drop-in replacement for OptimisticSortedList.
+ * - LookUp descends with optimistic lock coupling (HybridGuard), as in LockCouplingSortedList
+ * - Writers descend optimistically while recording the version of every predecessor,
+ *    then lock exactly those predecessors; a changed version means restart
+ * Unlinked towers are reclaimed through the EpochHandler
+ */
+template <typename T, typename Alloc = MallocAllocator>
+class OptimisticSkipList : public SortedList<T> {
+ public:
+  static constexpr uint8_t MAX_HEIGHT = 16;  // p = 1/4, enough for 4^16 keys
+
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Insert overwrites values in place while optimistic readers copy them");
+  static_assert(alignof(SkipNode<T>) <= Alloc::MAX_ALIGNMENT, "Alloc cannot align the towers");
+
+  OptimisticSkipList(EpochHandler *ep);
+  ~OptimisticSkipList();
+  void Insert(T value);
+  auto LookUp(T value, T &result) -> bool;
+  auto Delete(T value) -> bool;
+
+ private:
+  struct Position {
+    SkipNode<T> *preds[MAX_HEIGHT];  // nullptr stands for the head tower
+    uint64_t versions[MAX_HEIGHT];   // version of preds[level] when its next pointers were read
+    SkipNode<T> *succs[MAX_HEIGHT];
+  };
+
+  static auto RandomHeight() -> uint8_t;
+  /* Rounded up to the alignment, so that the allocator aligns towers of an over-aligned T as well */
+  static auto NodeSize(uint8_t height) -> uint64_t {
+    auto size = sizeof(SkipNode<T>) + height * sizeof(SkipNode<T> *);
+    return (size + alignof(SkipNode<T>) - 1) & ~(alignof(SkipNode<T>) - 1);
+  }
+  static auto StableVersion(HybridLock *lock) -> uint64_t;
+
+  auto NewSkipNode(T value, uint8_t height) -> SkipNode<T> *;
+  static void FreeSkipNode(void *ptr, uint64_t size);
+  auto LockOf(SkipNode<T> *node) -> HybridLock * { return (node == nullptr) ? &head_lock_ : &node->lock; }
+  auto NextOf(SkipNode<T> *node, int level) -> SkipNode<T> *& {
+    return (node == nullptr) ? head_[level] : node->next[level];
+  }
+  auto Find(const T &value, Position &pos) -> SkipNode<T> *;
+  auto LockPredecessors(Position &pos, uint8_t height) -> bool;
+  void UnlockPredecessors(Position &pos, uint8_t height);
+
+  SkipNode<T> *head_[MAX_HEIGHT] = {};
+  HybridLock head_lock_;
+  EpochHandler *epoch_;
+};
+
+}  // namespace FinalProject
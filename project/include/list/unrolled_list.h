@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common/simd.h"
+#include "list/list.h"
+#include "list/node.h"
+#include "common/allocator.h"
+#include "sync/epoch.h"
+#include "sync/guard.h"
+
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace FinalProject {
+
+/**
+ * Unrolled list: a linked list of chunks holding up to MAX_ENTRIES sorted values each,
+ *  drop-in replacement for OptimisticSortedList.
+ * - Every value of a chunk is smaller than every value of the next one. A value belongs to the first chunk
+ *    whose last value is >= it, or to the last chunk
+ * - Traversals hop from chunk to chunk with optimistic lock coupling (one HybridLock per chunk),
+ *    then search the chunk (KeyLowerBound(), vectorized for integral keys)
+ * - Writers upgrade the target chunk only: a full chunk is split in two halves,
+ *    a chunk that drops below a quarter is merged with its successor, and an empty one is unlinked
+ *    (which also locks its predecessor)
+ * Unlinked chunks are reclaimed through the EpochHandler
+ */
+template <typename T, uint64_t CHUNK_SIZE = 512, typename Alloc = MallocAllocator>
+class UnrolledSortedList : public SortedList<T> {
+ public:
+  using Chunk = UnrolledChunk<T, CHUNK_SIZE>;
+
+  static_assert(Chunk::MAX_ENTRIES >= 4, "CHUNK_SIZE too small for T");
+  static_assert(std::is_trivially_copyable_v<T>, "Values are shifted in place while optimistic readers copy them");
+  static_assert(alignof(Chunk) <= Alloc::MAX_ALIGNMENT, "Alloc cannot align the chunks");
+
+  UnrolledSortedList(EpochHandler *ep);
+  ~UnrolledSortedList();
+  void Insert(T value);
+  auto LookUp(T value, T &result) -> bool;
+  auto Delete(T value) -> bool;
+  auto Scan(const T &lo, const T &hi, std::span<T> out) -> uint64_t;
+
+ private:
+  static auto Count(Chunk *chunk) -> uint32_t;
+  static auto IsTarget(Chunk *chunk, Chunk *next, const T &value) -> bool;
+
+  static void FreeChunk(void *ptr, uint64_t size);
+
+  auto NewChunk() -> Chunk *;
+  void Split(Chunk *chunk);
+  void MergeNext(Chunk *chunk);
+
+  Chunk *head_{nullptr};
+  HybridLock head_lock_;  // protects head_, acts as the predecessor of the first chunk
+  EpochHandler *epoch_;
+};
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "common/histogram.h"
+#include "common/perf_event.h"
+#include "common/stats.h"
+#include "list/list.h"
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+namespace FinalProject {
+
+/**
+ * YCSB-style workload over any SortedList<uint64_t>:
+ * - the list is loaded with every other key of [0, keys)
+ * - operations are drawn from the lookup/insert/delete/scan mix (weights, usually percentages)
+ * - keys follow `distribution`. With LATEST, inserts append new keys and the other operations favour
+ *    the most recently inserted ones
+ */
+enum class KeyDistribution { UNIFORM, ZIPFIAN, LATEST };
+
+struct WorkloadConfig {
+  uint32_t lookups = 90;
+  uint32_t inserts = 5;
+  uint32_t deletes = 5;
+  uint32_t scans   = 0;
+
+  KeyDistribution distribution = KeyDistribution::UNIFORM;
+  double zipf_theta            = 0.99;  // Skew of ZIPFIAN and LATEST, in [0, 1)
+  uint64_t keys                = 1024;
+  uint64_t scan_length         = 100;  // Scans read at most this many values, starting at their key
+
+  uint32_t threads     = 1;
+  uint32_t duration_ms = 1000;
+  bool record_latency  = false;  // Time every operation, costs two clock reads per operation
+
+  /* Core YCSB workloads 'a' to 'e' (an update is an insert of an existing key). Throws std::invalid_argument */
+  static auto Preset(char name) -> WorkloadConfig;
+};
+
+enum class WorkloadOp : uint8_t { LOOKUP, INSERT, DELETE, SCAN, COUNT };
+
+struct WorkloadResult {
+  std::array<uint64_t, static_cast<uint32_t>(WorkloadOp::COUNT)> ops{};
+  std::array<LatencyHistogram, static_cast<uint32_t>(WorkloadOp::COUNT)> latencies{};  // ns, if record_latency
+  double seconds{0};
+  std::array<double, PerfEvent::NO_EVENTS> counters{};  // NaN when perf is unavailable
+  StatsSnapshot stats;                                   // Zero unless built with ENABLE_STATS
+
+  auto TotalOps() const -> uint64_t;
+  static auto Name(WorkloadOp op) -> const char *;
+};
+
+/**
+ * Zipfian ranks in [0, n), rank 0 being the most popular (Gray et al., "Quickly generating billion-record
+ *  synthetic databases"). Construction is O(n), sampling O(1)
+ */
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(uint64_t n, double theta);
+
+  auto Next(std::mt19937_64 &rng) -> uint64_t;
+
+ private:
+  uint64_t n_;
+  double theta_;
+  double alpha_;
+  double zeta_n_;
+  double eta_;
+};
+
+void LoadWorkload(SortedList<uint64_t> &list, const WorkloadConfig &config);
+
+/**
+ * Replay pre-generated operation streams on `config.threads` workers for `config.duration_ms`.
+ * Throws std::logic_error if the mix has scans and the list does not support them
+ */
+auto RunWorkload(SortedList<uint64_t> &list, const WorkloadConfig &config) -> WorkloadResult;
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -1,33 +1,101 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+#include "common/stats.h"
+#include "sync/thread_table.h"
+
 namespace FinalProject {
 
+/**
+ * Cadence of the background reclaimer: it wakes up every `period`,
+ *  or earlier once a worker has more than `retired_bytes_threshold` bytes waiting
+ */
+struct ReclaimerConfig {
+  std::chrono::milliseconds period  = std::chrono::milliseconds(10);
+  uint64_t retired_bytes_threshold = 1ULL << 20;
+};
+
 struct EpochHandler {
   static constexpr uint64_t MAX_VALUE            = ~0ULL;
-  static constexpr uint64_t MAX_NUMBER_OF_WORKER = 128;
+  static constexpr uint64_t MAX_NUMBER_OF_WORKER = 128;  // Default number of pre-allocated records, not a limit
+  static constexpr bool PROTECTS_POINTERS        = false;  // see Guard
+  static constexpr uint64_t CACHE_LINE_SIZE      = 64;
+
+  /* Releases a retired pointer, e.g. the allocator the node came from. nullptr means free() */
+  using Deleter = void (*)(void *ptr, uint64_t size);
 
   struct ToFreePointer {
     void *ptr;
     uint64_t epoch;
+    uint64_t size;
+    Deleter deleter;
+
+    void Free() const {
+      Stats::Add(Counter::NODES_RECLAIMED);
+      (deleter == nullptr) ? free(ptr) : deleter(ptr, size);
+    }
   };
 
-  explicit EpochHandler(uint64_t no_threads);
+  /**
+   * Everything a worker owns, padded so that two workers never share a cache line.
+   * `local_epoch` is written on every EpochGuard and sits alone on the first line,
+   *  the retire list lives on the following line(s).
+   * Records are stored contiguously inside a ThreadTable segment, so the minimum-epoch scan is a sequential walk
+   */
+  struct alignas(CACHE_LINE_SIZE) ThreadRecord {
+    std::atomic<uint64_t> local_epoch{MAX_VALUE};
+    /* Only held for a push_back by the owner, or for a swap by the reclaimer */
+    alignas(CACHE_LINE_SIZE) std::mutex to_free_lock;
+    std::vector<ToFreePointer> to_free_ptr;
+    uint64_t to_free_bytes{0};
+  };
+
+  class Guard;
+
+  explicit EpochHandler(uint64_t no_threads = MAX_NUMBER_OF_WORKER);
   ~EpochHandler();
 
   void FreeOutdatedPtr(uint64_t tid);
   void AdvanceGlobalEpoch();
-  void DeferFreePointer(uint64_t tid, void *ptr);
+  void DeferFreePointer(uint64_t tid, void *ptr, uint64_t size = 0, Deleter deleter = nullptr);
+
+  /* Background reclamation, optional */
+  void StartReclaimer(const ReclaimerConfig &config = {});
+  void StopReclaimer();
+  auto RetiredBytes() -> uint64_t;
+
+  auto LocalEpoch(uint64_t tid) -> std::atomic<uint64_t> & { return records_[tid].local_epoch; }
+  auto ToFreePtr(uint64_t tid) -> std::vector<ToFreePointer> & { return records_[tid].to_free_ptr; }
+  auto Capacity() -> uint64_t { return records_.Capacity(); }
 
   /* Epoch-based ptr reclaimation */
-  const uint64_t no_threads;
-  std::atomic<uint64_t> global_epoch;
-  std::vector<std::atomic<uint64_t>> local_epoch;
-  // vector of to_free_ptr for each thread
-  std::vector<std::vector<ToFreePointer>> to_free_ptr = {};
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> global_epoch;
+
+ private:
+  auto MinEpoch() -> uint64_t;
+  void ReclaimerLoop();
+
+  ThreadTable<ThreadRecord> records_;
+  /* Lower bound of the minimum local epoch, which only ever increases. Avoids a rescan per FreeOutdatedPtr() */
+  std::atomic<uint64_t> cached_min_epoch_{0};
+
+  /* Reclaimer state, `limbo_` is only touched by the reclaimer thread */
+  ReclaimerConfig config_;
+  std::thread reclaimer_;
+  std::mutex reclaimer_mutex_;
+  std::condition_variable reclaimer_cv_;
+  bool stop_{false};
+  std::atomic<uint64_t> wake_threshold_{MAX_VALUE};
+  std::vector<ToFreePointer> limbo_;
+  std::atomic<uint64_t> limbo_bytes_{0};
 };
 
 class EpochGuard {
@@ -39,4 +107,18 @@ class EpochGuard {
   std::atomic<uint64_t> *epoch_;
 };
 
+/**
+ * Critical section of a reclaimer, as used by the lists which take the reclaimer as a template parameter.
+ * The epoch protects every node read inside of it, so Protect() has nothing to do
+ */
+class EpochHandler::Guard {
+ public:
+  Guard(EpochHandler *handler, uint64_t tid) : epoch_guard_(&handler->LocalEpoch(tid), handler->global_epoch) {}
+
+  void Protect(uint64_t, void *) {}
+
+ private:
+  EpochGuard epoch_guard_;
+};
+
 }  // namespace FinalProject
\ No newline at end of file
@@ -1,26 +1,62 @@
 #pragma once
 
 #include "sync/lock.h"
+#include "sync/scalable_lock.h"
+#include "sync/wait.h"
 
 namespace FinalProject {
 
 enum class GuardMode { OPTIMISTIC, SHARED, EXCLUSIVE, MOVED };
 
-class HybridGuard {
+/**
+ * RAII guard for the HybridLock family. Explicitly instantiated in guard.cc for
+ *  HybridLock (HybridGuard) and ScalableHybridLock (ScalableHybridGuard)
+ */
+template <typename Lock>
+class BasicHybridGuard {
  public:
-  HybridGuard(HybridLock *lock, GuardMode mode);
-  auto operator=(HybridGuard &&other) noexcept(false) -> HybridGuard &;
-  ~HybridGuard() noexcept(false);
+  BasicHybridGuard(Lock *lock, GuardMode mode);
+  BasicHybridGuard(Lock *lock, GuardMode mode, const WaitPolicy &policy);
+  auto operator=(BasicHybridGuard &&other) noexcept(false) -> BasicHybridGuard &;
+  ~BasicHybridGuard() noexcept(false);
 
   void Unlock();
 
   void OptimisticLock();
+  void UpgradeToExclusive();
   void ValidateOptimisticLock();
+  void CheckOptimisticLock();
+
+  // Exception-free variants: a failed validation is reported instead of thrown
+  auto TryUpgradeToExclusive() -> bool;
+  auto TryValidateOptimisticLock() -> bool;
+  auto TryCheckOptimisticLock() -> bool;
 
  private:
-  HybridLock *lock_;
+  void StopTimer();
+
+  Lock *lock_;
   GuardMode mode_;
   uint64_t state_{0};
+  WaitPolicy policy_;  // Copied, so that a guard may be given a temporary policy
+  [[no_unique_address]] StatsTimer timer_;  // Guard lifetime, for the Timer::*_GUARD histograms
 };
 
+using HybridGuard         = BasicHybridGuard<HybridLock>;
+using ScalableHybridGuard = BasicHybridGuard<ScalableHybridLock>;
+
+/**
+ * Run `read` under an optimistic guard of `lock` until the guard validates, and return its result.
+ * A restart is a plain loop iteration, no exception involved.
+ * `read` may observe inconsistent state, so it must not write anything that outlives a restart
+ */
+template <typename Lock, typename Fn>
+auto OptimisticRead(Lock *lock, Fn &&read) -> decltype(read()) {
+  while (true) {
+    BasicHybridGuard<Lock> guard(lock, GuardMode::OPTIMISTIC);
+    auto result = read();
+    if (guard.TryValidateOptimisticLock()) { return result; }
+  }
+}
+
 }  // namespace FinalProject
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "sync/epoch.h"
+#include "sync/thread_table.h"
+
+namespace FinalProject {
+
+/**
+ * Hazard-pointer reclamation, drop-in alternative to EpochHandler for the lists which take a `Reclaimer`.
+ * A reader publishes every node it is about to dereference in one of its hazard slots, and then proves that
+ *  the node is still linked (for the optimistic lists: the owner's version did not change).
+ * A retired node is freed once no slot points to it, so a stalled reader pins at most SLOTS_PER_THREAD nodes,
+ *  and every thread holds at most ScanThreshold() retired nodes
+ */
+class HazardPointerHandler {
+ public:
+  static constexpr uint64_t MAX_NUMBER_OF_WORKER = EpochHandler::MAX_NUMBER_OF_WORKER;
+  static constexpr uint64_t CACHE_LINE_SIZE      = EpochHandler::CACHE_LINE_SIZE;
+  static constexpr uint64_t SLOTS_PER_THREAD     = 2;  // predecessor and current node of a traversal
+  static constexpr bool PROTECTS_POINTERS        = true;
+
+  using Deleter       = EpochHandler::Deleter;
+  using ToFreePointer = EpochHandler::ToFreePointer;  // `epoch` is unused
+
+  struct alignas(CACHE_LINE_SIZE) ThreadRecord {
+    std::atomic<void *> hazards[SLOTS_PER_THREAD] = {};
+    /* Only touched by the owner */
+    alignas(CACHE_LINE_SIZE) std::vector<ToFreePointer> to_free_ptr;
+  };
+
+  class Guard;
+
+  explicit HazardPointerHandler(uint64_t no_threads = MAX_NUMBER_OF_WORKER);
+  ~HazardPointerHandler();
+
+  void FreeOutdatedPtr(uint64_t tid);
+  void DeferFreePointer(uint64_t tid, void *ptr, uint64_t size = 0, Deleter deleter = nullptr);
+
+  void Protect(uint64_t tid, uint64_t slot, void *ptr) { records_[tid].hazards[slot].store(ptr); }
+  void Clear(uint64_t tid);
+
+  auto ScanThreshold() -> uint64_t;
+  auto ToFreePtr(uint64_t tid) -> std::vector<ToFreePointer> & { return records_[tid].to_free_ptr; }
+  auto Capacity() -> uint64_t { return records_.Capacity(); }
+
+ private:
+  ThreadTable<ThreadRecord> records_;
+};
+
+/* Clears the hazard slots of the thread on exit, nodes published through it may be freed afterwards */
+class HazardPointerHandler::Guard {
+ public:
+  Guard(HazardPointerHandler *handler, uint64_t tid) : handler_(handler), tid_(tid) {}
+  ~Guard() { handler_->Clear(tid_); }
+
+  void Protect(uint64_t slot, void *ptr) { handler_->Protect(tid_, slot, ptr); }
+
+ private:
+  HazardPointerHandler *handler_;
+  uint64_t tid_;
+};
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -4,9 +4,13 @@
 
 namespace FinalProject {
 
+template <typename Lock>
+class BasicHybridGuard;
+
 class HybridLock {
  public:
-  static constexpr uint64_t VERSION_MASK = (static_cast<uint64_t>(1) << 56) - 1;
+  static constexpr uint64_t PARKED       = static_cast<uint64_t>(1) << 55;  // somebody waits in Park()
+  static constexpr uint64_t VERSION_MASK = PARKED - 1;
   static constexpr uint64_t UNLOCKED     = 0;
   static constexpr uint64_t MAX_SHARED   = 254;  // # share-lock holders (1 -> MAX_SHARED)
   static constexpr uint64_t EXCLUSIVE    = 255;
@@ -31,8 +35,12 @@ class HybridLock {
   auto UpgradeLock(uint64_t old_state_w_version) -> bool;
   void DowngradeLock();
 
+  // Wait utilities
+  void Park(uint64_t old_state_w_version);
+
  protected:
-  friend class HybridGuard;
+  template <typename Lock>
+  friend class BasicHybridGuard;
 
   // Assertion utilities
   static auto IsExclusivelyLocked(uint64_t v) -> bool { return LockState(v) == EXCLUSIVE; }
@@ -51,6 +59,8 @@ class HybridLock {
     return static_cast<uint64_t>((((old_state_and_version << 8) >> 8) + 1) | new_state << 56);
   }
 
+  void ReleaseExclusive(uint64_t new_state);
+
   std::atomic<uint64_t> state_and_version_;
 };
 
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "sync/lock.h"
+
+#include <atomic>
+
+namespace FinalProject {
+
+/**
+ * HybridLock whose shared holders are counted in cache-line padded per-thread slots
+ *  (big-reader lock) instead of the state byte, so shared acquisitions of different threads
+ *  do not bounce the same cache line and there is no MAX_SHARED limit.
+ * The state byte is only UNLOCKED or EXCLUSIVE, and exclusive unlocks still bump the version,
+ *  so optimistic readers work exactly as with HybridLock.
+ *
+ * Writers pay for it: TryLockExclusive() blocks new readers first, then waits for every slot to drain
+ */
+class ScalableHybridLock : private HybridLock {
+ public:
+  static constexpr uint64_t READER_SLOTS = 64;
+
+  using HybridLock::EXCLUSIVE;
+  using HybridLock::PARKED;
+  using HybridLock::UNLOCKED;
+  using HybridLock::VERSION_MASK;
+
+  ScalableHybridLock()                       = default;
+  ~ScalableHybridLock()                      = default;
+  auto operator=(const ScalableHybridLock &) = delete;  // No COPY constructor
+  auto operator=(ScalableHybridLock &&)      = delete;  // No MOVE constructor
+
+  // State utilities
+  using HybridLock::LockState;
+  using HybridLock::StateAndVersion;
+  using HybridLock::Version;
+  auto Readers() -> uint64_t;
+
+  // Lock utilities
+  auto TryLockExclusive(uint64_t old_state_w_version) -> bool;
+  using HybridLock::UnlockExclusive;
+  auto TryLockShared(uint64_t old_state_w_version) -> bool;
+  void UnlockShared();
+  auto UpgradeLock(uint64_t old_state_w_version) -> bool;
+  void DowngradeLock();
+
+  // Wait utilities
+  using HybridLock::Park;
+
+ private:
+  struct alignas(64) ReaderSlot {
+    std::atomic<uint64_t> count{0};
+  };
+
+  static auto Slot() -> uint64_t;
+  void WaitForReaders(uint64_t remaining);
+
+  ReaderSlot readers_[READER_SLOTS];
+};
+
+}  // namespace FinalProject
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+
+namespace FinalProject {
+
+/**
+ * Per-thread records indexed by `thread_id`, shared by the memory reclaimers.
+ * Records are allocated SEGMENT_SIZE at a time on first access and never move,
+ *  so a reference stays valid while the table grows.
+ * Segments [0, no_segments_) are always allocated, so scans stop at the high-water mark
+ */
+template <typename Record>
+class ThreadTable {
+ public:
+  static constexpr uint64_t SEGMENT_SIZE = 64;
+  static constexpr uint64_t MAX_SEGMENTS = 1024;  // i.e. up to 65536 concurrently registered threads
+
+  explicit ThreadTable(uint64_t capacity) {
+    if (capacity > 0) { Grow((capacity - 1) / SEGMENT_SIZE); }
+  }
+
+  ~ThreadTable() {
+    for (auto idx = 0ULL; idx < no_segments_.load(); idx++) { delete[] segments_[idx].load(); }
+  }
+
+  ThreadTable(const ThreadTable &)                     = delete;
+  auto operator=(const ThreadTable &) -> ThreadTable & = delete;
+
+  auto operator[](uint64_t tid) -> Record & {
+    auto segment = segments_[tid / SEGMENT_SIZE].load(std::memory_order_acquire);
+    if (segment == nullptr) [[unlikely]] { segment = Grow(tid / SEGMENT_SIZE); }
+    return segment[tid % SEGMENT_SIZE];
+  }
+
+  auto Capacity() -> uint64_t { return no_segments_.load() * SEGMENT_SIZE; }
+
+  template <typename Fn>
+  void ForEach(Fn &&fn) {
+    auto no_segments = no_segments_.load();
+    for (auto idx = 0ULL; idx < no_segments; idx++) {
+      auto segment = segments_[idx].load(std::memory_order_acquire);
+      for (auto offset = 0ULL; offset < SEGMENT_SIZE; offset++) { fn(segment[offset]); }
+    }
+  }
+
+ private:
+  /* Allocate every missing segment up to `segment_idx`, only the first access of a new thread id ends up here */
+  auto Grow(uint64_t segment_idx) -> Record * {
+    if (segment_idx >= MAX_SEGMENTS) { throw std::out_of_range("ThreadTable: too many registered threads"); }
+    std::lock_guard guard(grow_lock_);
+    for (auto idx = no_segments_.load(); idx <= segment_idx; idx++) {
+      segments_[idx].store(new Record[SEGMENT_SIZE], std::memory_order_release);
+      no_segments_.store(idx + 1);
+    }
+    return segments_[segment_idx].load();
+  }
+
+  std::atomic<Record *> segments_[MAX_SEGMENTS] = {};
+  std::atomic<uint64_t> no_segments_{0};
+  std::mutex grow_lock_;
+};
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "common/stats.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace FinalProject {
+
+/**
+ * How a guard waits for a lock it could not acquire:
+ *  1. `spin_iterations` attempts separated by a single `pause`
+ *  2. `backoff_iterations` attempts with exponential backoff, up to `max_backoff_pauses` pauses
+ *  3. park on the lock word until the holder releases it (or yield if `park` is false)
+ */
+struct WaitPolicy {
+  uint32_t spin_iterations;
+  uint32_t backoff_iterations;
+  uint32_t max_backoff_pauses;
+  bool park;
+
+  /* Process-wide policy used by guards which are not given one. Read-only; pass a tuned policy explicitly instead */
+  static auto Default() -> const WaitPolicy &;
+};
+
+/* State of one acquisition loop. With stats enabled, it also times the loop from its first failed attempt */
+class Waiter {
+ public:
+  explicit Waiter(const WaitPolicy &policy) : policy_(policy) {}
+  ~Waiter() {
+    if constexpr (STATS_ENABLED) {
+      if (wait_start_ != 0) { RecordWait(); }
+    }
+  }
+
+  auto Pause() -> bool;
+
+ private:
+  void RecordWait();
+
+  const WaitPolicy &policy_;
+  uint32_t attempt_{0};
+  uint32_t backoff_{1};
+  uint64_t wait_start_{0};  // Steady clock nanoseconds, 0 while the loop has not waited yet
+};
+
+void CpuPause();
+
+/**
+ * How many optimistic attempts a reader makes before it falls back to a SHARED acquisition,
+ *  i.e. queues behind the writer instead of restarting again.
+ * With `adaptive`, the budget shrinks while the observed restart rate of the data structure is high
+ */
+struct RestartPolicy {
+  uint32_t max_optimistic_attempts;
+  bool adaptive;
+
+  static auto Default() -> RestartPolicy { return {8, true}; }
+  static auto Unbounded() -> RestartPolicy { return {~0U, false}; }
+};
+
+/* Restart rate of one data structure, shared by all of its readers */
+class RestartTracker {
+ public:
+  static constexpr uint32_t SAMPLE_PERIOD = 64;  // Restart-free operations decay the rate once per period
+
+  explicit RestartTracker(const RestartPolicy &policy) : policy_(policy) {}
+
+  auto Budget() const -> uint32_t;
+  void Record(uint32_t restarts);
+
+ private:
+  const RestartPolicy policy_;
+  std::atomic<uint32_t> rate_{0};     // Moving average of restarts per restarting operation, 8 fractional bits
+  std::atomic<uint32_t> skipped_{0};  // Restart-free operations since the last decay
+};
+
+}  // namespace FinalProject
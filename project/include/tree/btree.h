@@ -0,0 +1,48 @@
+#pragma once
+
+#include "common/simd.h"
+#include "list/list.h"
+#include "sync/epoch.h"
+#include "sync/guard.h"
+#include "tree/node.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace FinalProject {
+
+/**
+ * B+-tree with optimistic lock coupling (one HybridLock per node), same API as the sorted lists.
+ * - Readers descend optimistically: the child's version is read before the parent is validated
+ * - Writers upgrade only the leaf (and its parent on a split) to exclusive.
+ *    Full inner nodes are split eagerly on the way down, so a split never propagates upwards
+ * - Leaves which become empty are unlinked from their parent and reclaimed through the EpochHandler
+ */
+template <typename T, uint64_t NODE_SIZE = 4096>
+class OptimisticBTree : public SortedList<T> {
+ public:
+  using Leaf  = BTreeLeaf<T, NODE_SIZE>;
+  using Inner = BTreeInner<T, NODE_SIZE>;
+
+  static_assert(Leaf::MAX_ENTRIES >= 2 && Inner::MAX_ENTRIES >= 2, "NODE_SIZE too small for T");
+  static_assert(std::is_trivially_copyable_v<T>, "Leaf values are shifted in place while optimistic readers copy them");
+
+  OptimisticBTree(EpochHandler *ep);
+  ~OptimisticBTree();
+  void Insert(T value);
+  auto LookUp(T value, T &result) -> bool;
+  auto Delete(T value) -> bool;
+
+ private:
+  auto NewLeaf() -> Leaf *;
+  auto NewInner() -> Inner *;
+  static void FreeNode(void *ptr, uint64_t size);
+  void FreeSubtree(BTreeNode *node);
+  void SplitChild(Inner *parent, BTreeNode *child);
+
+  BTreeNode *root_;
+  HybridLock root_lock_;  // protects root_, acts as the parent of the root
+  EpochHandler *epoch_;
+};
+
+}  // namespace FinalProject
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "sync/lock.h"
+
+#include <cstdint>
+
+namespace FinalProject {
+
+/* Common header of inner nodes and leaves, `lock` protects the whole node */
+struct BTreeNode {
+  HybridLock lock;
+  uint16_t count{0};
+  bool is_leaf;
+
+  explicit BTreeNode(bool is_leaf) : is_leaf(is_leaf) {}
+  ~BTreeNode() = default;
+};
+
+/* Leaf: `count` sorted values, sized to fill NODE_SIZE bytes */
+template <typename T, uint64_t NODE_SIZE>
+struct BTreeLeaf : BTreeNode {
+  static constexpr uint64_t MAX_ENTRIES = (NODE_SIZE - sizeof(BTreeNode)) / sizeof(T);
+
+  T values[MAX_ENTRIES];
+
+  BTreeLeaf() : BTreeNode(true) {}
+  ~BTreeLeaf() = default;
+
+  auto IsFull() -> bool { return count == MAX_ENTRIES; }
+};
+
+/**
+ * Inner node: `count` separators and `count + 1` children.
+ * children[i] holds the values in (keys[i - 1], keys[i]]
+ */
+template <typename T, uint64_t NODE_SIZE>
+struct BTreeInner : BTreeNode {
+  static constexpr uint64_t MAX_ENTRIES =
+    (NODE_SIZE - sizeof(BTreeNode) - sizeof(BTreeNode *)) / (sizeof(T) + sizeof(BTreeNode *));
+
+  T keys[MAX_ENTRIES];
+  BTreeNode *children[MAX_ENTRIES + 1];
+
+  BTreeInner() : BTreeNode(false) {}
+  ~BTreeInner() = default;
+
+  auto IsFull() -> bool { return count == MAX_ENTRIES; }
+};
+
+}  // namespace FinalProject
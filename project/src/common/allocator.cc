@@ -0,0 +1,130 @@
+#include "common/allocator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace FinalProject {
+
+/* malloc() already aligns to max_align_t, only over-aligned sizes need aligned_alloc() */
+auto MallocAllocator::Allocate(uint64_t size) -> void * {
+  auto alignment = std::min(size & (~size + 1), MAX_ALIGNMENT);
+  auto memory    = (alignment <= alignof(std::max_align_t)) ? malloc(size) : std::aligned_alloc(alignment, size);
+  if (memory == nullptr) { throw std::bad_alloc(); }
+  return memory;
+}
+
+void MallocAllocator::Deallocate(void *ptr, uint64_t) { free(ptr); }
+
+namespace {
+
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+/* Singly linked list of free blocks of one size class */
+struct FreeList {
+  FreeBlock *head{nullptr};
+  uint64_t count{0};
+
+  void Push(void *ptr) {
+    auto block  = static_cast<FreeBlock *>(ptr);
+    block->next = head;
+    head        = block;
+    count++;
+  }
+
+  auto Pop() -> void * {
+    auto block = head;
+    head       = block->next;
+    count--;
+    return block;
+  }
+
+  /* Move up to `no_blocks` blocks to `other` */
+  void MoveTo(FreeList &other, uint64_t no_blocks) {
+    for (; no_blocks > 0 && head != nullptr; no_blocks--) { other.Push(Pop()); }
+  }
+};
+
+/* Blocks which overflowed a thread cache, plus every chunk ever allocated */
+struct SharedPool {
+  std::mutex lock;
+  FreeList lists[PoolAllocator::NO_SIZE_CLASSES];
+  std::vector<void *> chunks;
+
+  ~SharedPool() {
+    for (auto chunk : chunks) { free(chunk); }
+  }
+};
+
+auto Shared() -> SharedPool & {
+  static SharedPool pool;
+  return pool;
+}
+
+struct ThreadCache {
+  FreeList lists[PoolAllocator::NO_SIZE_CLASSES];
+
+  /* A dying thread gives its blocks back, someone else will reuse them */
+  ~ThreadCache() {
+    auto &shared = Shared();
+    std::lock_guard guard(shared.lock);
+    for (auto idx = 0ULL; idx < PoolAllocator::NO_SIZE_CLASSES; idx++) {
+      lists[idx].MoveTo(shared.lists[idx], lists[idx].count);
+    }
+  }
+};
+
+thread_local ThreadCache cache;
+
+/* Index of the free list serving `size`. An empty request gets the smallest block instead of underflowing */
+auto SizeClass(uint64_t size) -> uint64_t {
+  return (std::max<uint64_t>(size, 1) + PoolAllocator::SIZE_CLASS - 1) / PoolAllocator::SIZE_CLASS - 1;
+}
+
+/**
+ * Slow path of Allocate(): take a batch from the shared pool, or carve a new chunk into blocks.
+ * Blocks start at multiples of their size within an aligned chunk, which gives them their natural alignment
+ */
+void Refill(FreeList &local, uint64_t size_class) {
+  auto &shared = Shared();
+  std::lock_guard guard(shared.lock);
+  shared.lists[size_class].MoveTo(local, PoolAllocator::CACHE_LIMIT / 2);
+  if (local.count > 0) { return; }
+
+  auto block_size = (size_class + 1) * PoolAllocator::SIZE_CLASS;
+  auto chunk      = static_cast<char *>(std::aligned_alloc(PoolAllocator::MAX_ALIGNMENT, PoolAllocator::CHUNK_SIZE));
+  if (chunk == nullptr) { throw std::bad_alloc(); }
+  shared.chunks.push_back(chunk);
+  for (auto offset = 0ULL; offset + block_size <= PoolAllocator::CHUNK_SIZE; offset += block_size) {
+    local.Push(chunk + offset);
+  }
+}
+
+}  // namespace
+
+auto PoolAllocator::Allocate(uint64_t size) -> void * {
+  if (size > MAX_POOLED_SIZE) { return MallocAllocator::Allocate(size); }
+  auto size_class = SizeClass(size);
+  auto &local     = cache.lists[size_class];
+  if (local.head == nullptr) [[unlikely]] { Refill(local, size_class); }
+  return local.Pop();
+}
+
+void PoolAllocator::Deallocate(void *ptr, uint64_t size) {
+  if (size > MAX_POOLED_SIZE) { return MallocAllocator::Deallocate(ptr, size); }
+  auto size_class = SizeClass(size);
+  auto &local     = cache.lists[size_class];
+  local.Push(ptr);
+  if (local.count > CACHE_LIMIT) [[unlikely]] {
+    auto &shared = Shared();
+    std::lock_guard guard(shared.lock);
+    local.MoveTo(shared.lists[size_class], CACHE_LIMIT / 2);
+  }
+}
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "common/histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace FinalProject {
+
+auto LatencyHistogram::UpperBound(uint32_t bucket) -> uint64_t {
+  if (bucket < SUB_BUCKETS) { return bucket; }
+  auto shift = bucket / SUB_BUCKETS - 1;
+  auto sub   = bucket % SUB_BUCKETS + SUB_BUCKETS;
+  // The last bucket ends at UINT64_MAX, (sub + 1) << shift would overflow
+  return (sub == 2 * SUB_BUCKETS - 1 && shift == 63 - SUB_BUCKET_BITS) ? ~0ULL : ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::RecordBucket(uint32_t bucket, uint64_t count) {
+  if (count == 0) { return; }
+  counts_[bucket] += count;
+  max_ = std::max(max_, UpperBound(bucket));
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &other) {
+  for (auto idx = 0U; idx < NO_BUCKETS; idx++) { counts_[idx] += other.counts_[idx]; }
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::Reset() {
+  counts_.fill(0);
+  max_ = 0;
+}
+
+auto LatencyHistogram::Count() const -> uint64_t {
+  uint64_t total = 0;
+  for (auto count : counts_) { total += count; }
+  return total;
+}
+
+auto LatencyHistogram::Percentile(double quantile) const -> uint64_t {
+  auto total = Count();
+  if (total == 0) { return 0; }
+  auto rank = std::max<uint64_t>(1, std::ceil(quantile * total));
+  uint64_t seen = 0;
+  for (auto idx = 0U; idx < NO_BUCKETS; idx++) {
+    seen += counts_[idx];
+    if (seen >= rank) { return std::min(UpperBound(idx), max_); }
+  }
+  return max_;
+}
+
+void LatencyHistogram::Print(std::ostream &out) const {
+  out << "p50 " << Percentile(0.5) << " p99 " << Percentile(0.99) << " p99.9 " << Percentile(0.999) << " max "
+      << Max();
+}
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "common/perf_event.h"
+#include "common/stats.h"
+
+#include <cmath>
+#include <limits>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace FinalProject {
+
+namespace {
+
+#ifdef __linux__
+constexpr uint64_t CONFIGS[PerfEvent::NO_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+/* What read() returns with PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING */
+struct ReadFormat {
+  uint64_t value;
+  uint64_t time_enabled;
+  uint64_t time_running;
+};
+#endif
+
+}  // namespace
+
+PerfEvent::PerfEvent() {
+  fds_.fill(-1);
+#ifdef __linux__
+  for (auto idx = 0U; idx < NO_EVENTS; idx++) {
+    perf_event_attr attr{};
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = CONFIGS[idx];
+    attr.disabled       = 1;
+    attr.inherit        = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    fds_[idx]           = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+#endif
+}
+
+PerfEvent::~PerfEvent() {
+#ifdef __linux__
+  for (auto fd : fds_) {
+    if (fd >= 0) { close(fd); }
+  }
+#endif
+}
+
+auto PerfEvent::Available() const -> bool {
+  for (auto fd : fds_) {
+    if (fd >= 0) { return true; }
+  }
+  return false;
+}
+
+void PerfEvent::StartCounters() {
+#ifdef __linux__
+  for (auto fd : fds_) {
+    if (fd < 0) { continue; }
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+#endif
+  start_ns_ = NowNs();
+}
+
+/**
+ * Counters of the threads which already exited are folded into the parent counter,
+ *  so workers should be joined before the phase is stopped
+ */
+void PerfEvent::StopCounters() {
+  seconds_ = static_cast<double>(NowNs() - start_ns_) / 1e9;
+  values_.fill(std::numeric_limits<double>::quiet_NaN());
+#ifdef __linux__
+  for (auto idx = 0U; idx < NO_EVENTS; idx++) {
+    if (fds_[idx] < 0) { continue; }
+    ioctl(fds_[idx], PERF_EVENT_IOC_DISABLE, 0);
+    ReadFormat data{};
+    if (read(fds_[idx], &data, sizeof(data)) != sizeof(data) || data.time_running == 0) { continue; }
+    values_[idx] = static_cast<double>(data.value) * data.time_enabled / data.time_running;
+  }
+#endif
+}
+
+auto PerfEvent::Value(Event event) const -> double { return values_[event]; }
+
+auto PerfEvent::Name(Event event) -> const char * {
+  switch (event) {
+    case CYCLES: return "cycles";
+    case INSTRUCTIONS: return "instructions";
+    case CACHE_MISSES: return "cache-misses";
+    case BRANCH_MISSES: return "branch-misses";
+    default: return "unknown";
+  }
+}
+
+void PerfEvent::PrintReport(std::ostream &out, uint64_t ops) const {
+  for (auto idx = 0U; idx < NO_EVENTS; idx++) {
+    auto event = static_cast<Event>(idx);
+    out << Name(event) << ": ";
+    if (std::isnan(values_[idx])) {
+      out << "n/a\n";
+    } else {
+      out << values_[idx] / ops << "\n";
+    }
+  }
+}
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "common/stats.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+namespace FinalProject {
+
+namespace {
+
+constexpr auto NO_COUNTERS = static_cast<uint32_t>(Counter::COUNT);
+constexpr auto NO_TIMERS   = static_cast<uint32_t>(Timer::COUNT);
+
+/**
+ * Counters and histogram buckets of one thread. Only the owner writes them, with a relaxed load + store
+ *  instead of a locked RMW, readers aggregate them whenever a snapshot is taken.
+ * Allocated on the first event of the thread, so that threads which never record anything carry no buckets
+ */
+struct alignas(64) ThreadCounters {
+  std::atomic<uint64_t> values[NO_COUNTERS] = {};
+  std::atomic<uint64_t> buckets[NO_TIMERS][LatencyHistogram::NO_BUCKETS] = {};
+
+  ThreadCounters();
+  ~ThreadCounters();
+
+  static void Bump(std::atomic<uint64_t> &slot, uint64_t value) {
+    slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+  void AddTo(StatsSnapshot &snapshot) const;
+};
+
+struct Registry {
+  std::mutex lock;
+  std::unordered_set<ThreadCounters *> threads;
+  StatsSnapshot exited;  // Counters of the threads which are gone
+};
+
+auto Global() -> Registry & {
+  static Registry registry;
+  return registry;
+}
+
+ThreadCounters::ThreadCounters() {
+  auto &registry = Global();
+  std::lock_guard guard(registry.lock);
+  registry.threads.insert(this);
+}
+
+ThreadCounters::~ThreadCounters() {
+  auto &registry = Global();
+  std::lock_guard guard(registry.lock);
+  AddTo(registry.exited);
+  registry.threads.erase(this);
+}
+
+void ThreadCounters::AddTo(StatsSnapshot &snapshot) const {
+  for (auto idx = 0U; idx < NO_COUNTERS; idx++) { snapshot.values[idx] += values[idx].load(std::memory_order_relaxed); }
+  for (auto timer = 0U; timer < NO_TIMERS; timer++) {
+    for (auto bucket = 0U; bucket < LatencyHistogram::NO_BUCKETS; bucket++) {
+      snapshot.latencies[timer].RecordBucket(bucket, buckets[timer][bucket].load(std::memory_order_relaxed));
+    }
+  }
+}
+
+thread_local std::unique_ptr<ThreadCounters> local_counters;
+
+auto Local() -> ThreadCounters & {
+  if (!local_counters) { local_counters = std::make_unique<ThreadCounters>(); }
+  return *local_counters;
+}
+
+}  // namespace
+
+void Stats::AddLocal(uint32_t counter, uint64_t value) { ThreadCounters::Bump(Local().values[counter], value); }
+
+void Stats::RecordLocal(uint32_t timer, uint64_t ns) {
+  ThreadCounters::Bump(Local().buckets[timer][LatencyHistogram::BucketOf(ns)], 1);
+}
+
+auto Stats::Snapshot() -> StatsSnapshot {
+  auto &registry = Global();
+  std::lock_guard guard(registry.lock);
+  auto snapshot = registry.exited;
+  for (auto thread : registry.threads) { thread->AddTo(snapshot); }
+  return snapshot;
+}
+
+void Stats::Reset() {
+  auto &registry = Global();
+  std::lock_guard guard(registry.lock);
+  registry.exited = StatsSnapshot();
+  for (auto thread : registry.threads) {
+    for (auto &value : thread->values) { value.store(0, std::memory_order_relaxed); }
+    for (auto &timer : thread->buckets) {
+      for (auto &bucket : timer) { bucket.store(0, std::memory_order_relaxed); }
+    }
+  }
+}
+
+auto StatsSnapshot::operator-(const StatsSnapshot &other) const -> StatsSnapshot {
+  StatsSnapshot delta;
+  for (auto idx = 0U; idx < NO_COUNTERS; idx++) { delta.values[idx] = values[idx] - other.values[idx]; }
+  for (auto timer = 0U; timer < NO_TIMERS; timer++) {
+    for (auto bucket = 0U; bucket < LatencyHistogram::NO_BUCKETS; bucket++) {
+      delta.latencies[timer].RecordBucket(
+        bucket, latencies[timer].BucketCount(bucket) - other.latencies[timer].BucketCount(bucket));
+    }
+  }
+  return delta;
+}
+
+auto StatsSnapshot::Name(Counter counter) -> const char * {
+  switch (counter) {
+    case Counter::OPTIMISTIC_ATTEMPTS: return "optimistic_attempts";
+    case Counter::VALIDATION_FAILURES: return "validation_failures";
+    case Counter::SHARED_ACQUISITIONS: return "shared_acquisitions";
+    case Counter::EXCLUSIVE_ACQUISITIONS: return "exclusive_acquisitions";
+    case Counter::SPIN_ITERATIONS: return "spin_iterations";
+    case Counter::WAIT_NS: return "wait_ns";
+    case Counter::EPOCH_ADVANCES: return "epoch_advances";
+    case Counter::NODES_RECLAIMED: return "nodes_reclaimed";
+    default: return "unknown";
+  }
+}
+
+auto StatsSnapshot::Name(Timer timer) -> const char * {
+  switch (timer) {
+    case Timer::OPTIMISTIC_GUARD: return "optimistic_guard_ns";
+    case Timer::SHARED_GUARD: return "shared_guard_ns";
+    case Timer::EXCLUSIVE_GUARD: return "exclusive_guard_ns";
+    default: return "unknown";
+  }
+}
+
+void StatsSnapshot::Print(std::ostream &out) const {
+  for (auto idx = 0U; idx < NO_COUNTERS; idx++) {
+    out << Name(static_cast<Counter>(idx)) << " " << values[idx] << "\n";
+  }
+  for (auto timer = 0U; timer < NO_TIMERS; timer++) {
+    out << Name(static_cast<Timer>(timer)) << " ";
+    latencies[timer].Print(out);
+    out << "\n";
+  }
+}
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -5,15 +5,43 @@
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
 #include <stdexcept>
+#include <vector>
 
 namespace FinalProject {
 
-std::atomic<int> worker_atomic_int = 0;
+/* Smallest free id first, so that the per-thread tables stay as small as possible */
+static std::mutex registry_lock;
+static std::priority_queue<int, std::vector<int>, std::greater<int>> free_ids;
+static int next_id = 0;
+
+auto AcquireThreadId() -> int {
+  std::lock_guard guard(registry_lock);
+  if (free_ids.empty()) { return next_id++; }
+  auto id = free_ids.top();
+  free_ids.pop();
+  return id;
+}
+
+void ReleaseThreadId(int id) {
+  std::lock_guard guard(registry_lock);
+  free_ids.push(id);
+}
+
+/* Holds the id of the current thread, and releases it on thread exit */
+struct ThreadRegistration {
+  int id = AcquireThreadId();
+  ~ThreadRegistration() { ReleaseThreadId(id); }
+};
 
-thread_local int thread_id;
+static thread_local ThreadRegistration registration;
+thread_local int thread_id = registration.id;
 
-void InitializeThread() { thread_id = ++worker_atomic_int; }
+/* Registration is implicit on first use, this only forces it to happen now */
+void InitializeThread() { (void)thread_id; }
 
 void HandleSegfault(int signo, siginfo_t *info, void *extra) { throw RestartException(); }
 
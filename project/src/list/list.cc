@@ -1,31 +1,39 @@
 #include "list/list.h"
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <cassert>
 #include <cstdlib>
 #include <mutex>
+#include <numeric>
 #include "sync/epoch.h"
 #include "sync/lock.h"
 #include "common/utils.h"
 
 namespace FinalProject {
 
-template <typename T>
-auto SortedList<T>::NewNode(T value, Node<T> *next) -> Node<T>* {
-  auto memory = malloc(sizeof(Node<T>));
-  return new (memory) Node<T>(value, next);
-}
-
-template <typename T>
-MutexSortedList<T>::~MutexSortedList() {
+template <typename T, typename Alloc>
+MutexSortedList<T, Alloc>::~MutexSortedList() {
   Node<T> *tmp;
   for (; root_ != nullptr; root_ = tmp) {
     tmp = root_->next;
-    free(root_);
+    FreeNode(root_);
   }
 }
-template <typename T>
-void MutexSortedList<T>::Insert(T value) {
+
+template <typename T, typename Alloc>
+auto MutexSortedList<T, Alloc>::NewNode(T value, Node<T> *next) -> Node<T> * {
+  auto memory = Alloc::Allocate(sizeof(Node<T>));
+  return new (memory) Node<T>(value, next);
+}
+
+template <typename T, typename Alloc>
+void MutexSortedList<T, Alloc>::FreeNode(Node<T> *node) {
+  node->~Node();
+  Alloc::Deallocate(node, sizeof(*node));
+}
+template <typename T, typename Alloc>
+void MutexSortedList<T, Alloc>::Insert(T value) {
   std::unique_lock guard(lock_);
   if (root_ == nullptr || root_->value <=> value > 0) {
     root_ = this->NewNode(value, root_);
@@ -33,7 +41,8 @@ void MutexSortedList<T>::Insert(T value) {
   }
   bool found = false;
   Node<T> *prev = nullptr;
-  for (auto current = root_; current != nullptr; current = current->next) {
+  Node<T> *current;
+  for (current = root_; current != nullptr; current = current->next) {
     if (current->value <=> value > 0) { break; }
     if (current->value <=> value == 0) {
       found = true;
@@ -42,14 +51,14 @@ void MutexSortedList<T>::Insert(T value) {
     prev = current;
   }
   if (found) {
-    assert(prev->next != nullptr);
-    prev->next->value = value;
+    // `current` may be the root, in which case there is no predecessor
+    current->value = value;
   } else {
     prev->next = this->NewNode(value, prev->next);
   }
 }
-template <typename T>
-auto MutexSortedList<T>::LookUp(T value, T &result) -> bool {
+template <typename T, typename Alloc>
+auto MutexSortedList<T, Alloc>::LookUp(T value, T &result) -> bool {
   std::shared_lock guard(lock_);
   bool found = false;
   for (auto current = root_; current != nullptr; current = current->next) {
@@ -63,8 +72,8 @@ auto MutexSortedList<T>::LookUp(T value, T &result) -> bool {
 
   return found;
 }
-template <typename T>
-auto MutexSortedList<T>::Delete(T value) -> bool {
+template <typename T, typename Alloc>
+auto MutexSortedList<T, Alloc>::Delete(T value) -> bool {
   std::unique_lock guard(lock_);
 
   bool found = false;
@@ -86,96 +95,548 @@ auto MutexSortedList<T>::Delete(T value) -> bool {
 
   if (found) {
     assert(current != nullptr);
-    free(current);
+    FreeNode(current);
   }
   return found;
 }
 
-template <typename T>
-OptimisticSortedList<T>::OptimisticSortedList(EpochHandler *ep) : epoch_(ep) {}
+template <typename T, typename Alloc>
+auto MutexSortedList<T, Alloc>::Scan(const T &lo, const T &hi, std::span<T> out) -> uint64_t {
+  std::shared_lock guard(lock_);
+  uint64_t count = 0;
+  for (auto current = root_; current != nullptr && count < out.size(); current = current->next) {
+    if (current->value <=> hi >= 0) { break; }
+    if (current->value <=> lo >= 0) { out[count++] = current->value; }
+  }
+  return count;
+}
+
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::OptimisticSortedList(Reclaimer *reclaimer,
+                                                                               const RestartPolicy &policy)
+    : reclaimer_(reclaimer), restarts_(policy) {}
 
-template <typename T>
-OptimisticSortedList<T>::~OptimisticSortedList() {
-  Node<T> *tmp;
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+auto OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::NewNode(const T &value, NodeType *next) -> NodeType * {
+  return KeyTrait::template Make<Alloc>(Alloc::Allocate(sizeof(NodeType)), value, next);
+}
+
+/* Deleter of retired nodes, the split layout frees the payload along with its node */
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+void OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::FreeNode(void *ptr, uint64_t size) {
+  KeyTrait::template Destroy<Alloc>(static_cast<NodeType *>(ptr));
+  Alloc::Deallocate(ptr, size);
+}
+
+/**
+ * Update the value of the node `link` points to, under the exclusive lock.
+ * With an immutable layout, optimistic readers may still be copying the old payload:
+ *  a new node takes the place of the old one, which is retired
+ */
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+void OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::Overwrite(NodeType *&link, const T &value) {
+  if constexpr (KeyTrait::IMMUTABLE) {
+    auto old = link;
+    link     = NewNode(value, old->next);
+    reclaimer_->DeferFreePointer(thread_id, old, sizeof(*old), FreeNode);
+  } else {
+    link->value = value;
+  }
+}
+
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::~OptimisticSortedList() {
+  NodeType *tmp;
   for (; root_ != nullptr; root_ = tmp) {
     tmp = root_->next;
-    free(root_);
+    FreeNode(root_, sizeof(*root_));
   }
 }
 
-template <typename T>
-void OptimisticSortedList<T>::Insert(T value) { 
-  HybridGuard guard(&lock_, GuardMode::EXCLUSIVE);
-  if (root_ == nullptr || root_->value <=> value > 0) {
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+void OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::Insert(T value) { 
+  Guard guard(&lock_, GuardMode::EXCLUSIVE);
+  decltype(auto) key = KeyTrait::Of(value);
+  typename KeyTrait::Window window;  // Nodes in front of the insertion point, for the prefetch hints
+  if (root_ == nullptr || KeyTrait::Compare(root_, key, value) > 0) {
     root_ = this->NewNode( value, root_);
+    window.AfterInsert(root_);
     return;
   }
   bool found = false;
-  Node<T> *prev = nullptr;
-  for (auto current = root_; current != nullptr; current = current->next) {
-    if (current->value <=> value > 0) { break; }
-    if (current->value <=> value == 0) {
+  NodeType *prev = nullptr;
+  NodeType *current;
+  for (current = root_; current != nullptr; current = current->next) {
+    KeyTrait::Prefetch(current);
+    auto order = KeyTrait::Compare(current, key, value);
+    if (order > 0) { break; }
+    if (order == 0) {
       found = true;
       break;
     }
     prev = current;
+    window.Push(current);
   }
   if (found) {
-    assert(prev->next != nullptr);
-    prev->next->value = value;
+    // `current` may be the root, in which case there is no predecessor
+    auto &link = (prev == nullptr) ? root_ : prev->next;
+    Overwrite(link, value);
+    if constexpr (KeyTrait::IMMUTABLE) { window.AfterInsert(link); }
   } else {
     prev->next = this->NewNode(value, prev->next);
+    window.AfterInsert(prev->next);
+  }
+}
+
+/**
+ * Restarts are a plain branch: the guard reports a failed validation instead of throwing.
+ * Once the restart budget is spent, the last attempt takes the lock in SHARED mode and cannot fail.
+ * The value is copied into a snapshot and only reaches `result` after a successful validation
+ */
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+auto OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::LookUp(T value, T &result) -> bool {
+  decltype(auto) key = KeyTrait::Of(value);
+  auto budget        = restarts_.Budget();
+  for (uint32_t attempt = 0;; attempt++) {
+    typename Reclaimer::Guard reclaim_guard(reclaimer_, thread_id);
+    Guard hybrid_guard(&lock_, (attempt < budget) ? GuardMode::OPTIMISTIC : GuardMode::SHARED);
+    bool found = false;
+    auto valid = true;
+    ValueSnapshot<T> snapshot;
+    for (auto current = root_; current != nullptr; current = current->next) {
+      if constexpr (Reclaimer::PROTECTS_POINTERS) {
+        // `current` was read under `hybrid_guard`: it is still linked as long as the list did not change
+        reclaim_guard.Protect(0, current);
+        if (!(valid = hybrid_guard.TryCheckOptimisticLock())) { break; }
+      }
+      KeyTrait::Prefetch(current);
+      auto order = KeyTrait::Compare(current, key, value);
+      if (order > 0) { break; }
+      if (order == 0) {
+        found = true;
+        snapshot.Copy(KeyTrait::Value(current));
+        break;
+      }
+    }
+    if (valid && hybrid_guard.TryValidateOptimisticLock()) {
+      if (found) { snapshot.Publish(result); }
+      restarts_.Record(attempt);
+      return found;
+    }
+  }
+}
+
+/* Stable permutation which visits `keys` in ascending order, the identity if they are sorted already */
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+auto OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::SortedOrder(std::span<const T> keys)
+    -> std::vector<uint64_t> {
+  std::vector<uint64_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  if (!std::is_sorted(keys.begin(), keys.end())) {
+    std::stable_sort(order.begin(), order.end(), [&](uint64_t lhs, uint64_t rhs) { return keys[lhs] < keys[rhs]; });
+  }
+  return order;
+}
+
+/**
+ * Answer `keys[order[0]] <= keys[order[1]] <= ...` with a single walk of the list, under one reclaimer guard and
+ *  one guard in `mode`. Returns false if an OPTIMISTIC version changed, in which case `results` and `found` are
+ *  left alone: the values are copied into snapshots and only published after the validation
+ */
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+auto OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::LookUpSorted(std::span<const T> keys,
+                                                                             std::span<const uint64_t> order,
+                                                                             std::span<T> results,
+                                                                             std::span<bool> found,
+                                                                             GuardMode mode) -> bool {
+  std::vector<ValueSnapshot<T>> snapshots(order.size());
+  std::vector<bool> hits(order.size());
+  typename Reclaimer::Guard reclaim_guard(reclaimer_, thread_id);
+  Guard hybrid_guard(&lock_, mode);
+  auto current = root_;
+  for (uint64_t pos = 0; pos < order.size(); pos++) {
+    const auto &value  = keys[order[pos]];
+    decltype(auto) key = KeyTrait::Of(value);
+    while (true) {
+      if constexpr (Reclaimer::PROTECTS_POINTERS) {
+        reclaim_guard.Protect(0, current);
+        if (!hybrid_guard.TryCheckOptimisticLock()) { return false; }
+      }
+      if (current == nullptr || KeyTrait::Compare(current, key, value) >= 0) { break; }
+      KeyTrait::Prefetch(current);
+      current = current->next;
+    }
+    hits[pos] = current != nullptr && KeyTrait::Compare(current, key, value) == 0;
+    if (hits[pos]) { snapshots[pos].Copy(KeyTrait::Value(current)); }
+  }
+  if (!hybrid_guard.TryValidateOptimisticLock()) { return false; }
+  for (uint64_t pos = 0; pos < order.size(); pos++) {
+    found[order[pos]] = hits[pos];
+    if (hits[pos]) { snapshots[pos].Publish(results[order[pos]]); }
+  }
+  return true;
+}
+
+/**
+ * One walk and one validation for the whole batch, i.e. O(n + k) instead of k * O(n).
+ * A failed validation retries the same keys in halves, so that a busy list still lets small batches through.
+ * As in LookUp(), the restarts are bounded: once the budget is spent, the rest of the batch runs under one
+ *  SHARED guard
+ */
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+auto OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::LookUpBatch(std::span<const T> keys,
+                                                                          std::span<T> results,
+                                                                          std::span<bool> found) -> uint64_t {
+  assert(results.size() >= keys.size() && found.size() >= keys.size());
+  auto order        = SortedOrder(keys);
+  auto batch_size   = std::max<uint64_t>(order.size(), 1);
+  auto budget       = restarts_.Budget();
+  uint32_t restarts = 0;
+  for (uint64_t begin = 0; begin < order.size();) {
+    auto mode = (restarts < budget) ? GuardMode::OPTIMISTIC : GuardMode::SHARED;
+    if (mode == GuardMode::SHARED) { batch_size = order.size() - begin; }
+    auto batch = std::span<const uint64_t>(order).subspan(begin, std::min(batch_size, order.size() - begin));
+    if (LookUpSorted(keys, batch, results, found, mode)) {
+      begin += batch.size();
+    } else {
+      restarts++;
+      batch_size = std::max<uint64_t>(batch_size / 2, 1);
+    }
+  }
+  restarts_.Record(restarts);
+  return std::count(found.begin(), found.begin() + keys.size(), true);
+}
+
+/**
+ * Merge `values` into the list in one pass, under one exclusive section: readers restart once per batch.
+ * As with Insert(), an existing equal value is overwritten. Among equal values of the batch the last one wins
+ */
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+void OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::InsertBatch(std::span<const T> values) {
+  auto order = SortedOrder(values);
+
+  Guard guard(&lock_, GuardMode::EXCLUSIVE);
+  auto link = &root_;
+  for (auto idx : order) {
+    const auto &value  = values[idx];
+    decltype(auto) key = KeyTrait::Of(value);
+    while (*link != nullptr && KeyTrait::Compare(*link, key, value) < 0) {
+      KeyTrait::Prefetch(*link);
+      link = &(*link)->next;
+    }
+    if (*link != nullptr && KeyTrait::Compare(*link, key, value) == 0) {
+      Overwrite(*link, value);
+    } else {
+      *link = NewNode(value, *link);
+    }
   }
+  KeyTrait::Window::Rebuild(root_);
 }
 
-template <typename T>
-auto OptimisticSortedList<T>::LookUp(T value, T &result) -> bool { 
-   
-  while(true){ 
-    try{
-     EpochGuard epoch_guard(&(epoch_->local_epoch[thread_id]), epoch_->global_epoch); 
-     HybridGuard hybrid_guard(&lock_, GuardMode::OPTIMISTIC);
-     bool found = false;
-      for (auto current = root_; current != nullptr; current = current->next) {
-        if (current->value <=> value > 0) { break; }
-        if (current->value <=> value == 0) {
-           found     = true;
-           result = current->value;
-           break;
+/**
+ * Remove all of `values` in one pass, under one exclusive section. Returns the number of deleted values
+ */
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+auto OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::DeleteBatch(std::span<const T> values) -> uint64_t {
+  auto order   = SortedOrder(values);
+  auto deleted = 0ULL;
+
+  Guard guard(&lock_, GuardMode::EXCLUSIVE);
+  auto link = &root_;
+  for (auto idx : order) {
+    const auto &value  = values[idx];
+    decltype(auto) key = KeyTrait::Of(value);
+    while (*link != nullptr && KeyTrait::Compare(*link, key, value) < 0) {
+      KeyTrait::Prefetch(*link);
+      link = &(*link)->next;
+    }
+    if (*link != nullptr && KeyTrait::Compare(*link, key, value) == 0) {
+      auto current = *link;
+      *link        = current->next;
+      reclaimer_->DeferFreePointer(thread_id, current, sizeof(*current), FreeNode);
+      deleted++;
+    }
+  }
+  KeyTrait::Window::Rebuild(root_);
+  return deleted;
+}
+
+/**
+ * Range scan with snapshot semantics per chunk:
+ * - up to SCAN_CHUNK values are copied under the optimistic guard, the guard is checked,
+ *    and only then the chunk is handed to `visit`. A visitor never sees a value which was not validated
+ * - after a restart no value is visited twice: the scan continues after the last visited value.
+ *    It does walk the list again from root_, skipping the nodes up to that value, so a restart costs O(n).
+ *    Continuing from the last visited node is not safe: the whole list shares one version, so after a restart
+ *    nothing tells whether that node is still linked, and its `next` chain may already be unlinked
+ * - once the restart budget is spent, the rest of the range is scanned in SHARED mode so it cannot livelock.
+ *    `visit` must therefore not modify this list
+ */
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+template <typename Fn>
+  requires std::predicate<Fn, const T &>
+auto OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::Scan(const T &lo, const T &hi, Fn &&visit) -> uint64_t {
+  std::vector<T> chunk;
+  chunk.reserve(SCAN_CHUNK);
+  std::optional<T> resume;  // last visited value
+  uint64_t visited = 0;
+  decltype(auto) lo_key = KeyTrait::Of(lo);
+  decltype(auto) hi_key = KeyTrait::Of(hi);
+
+  auto budget = restarts_.Budget();
+  for (uint32_t attempt = 0;; attempt++) {
+    auto mode = (attempt < budget) ? GuardMode::OPTIMISTIC : GuardMode::SHARED;
+    typename Reclaimer::Guard reclaim_guard(reclaimer_, thread_id);
+    Guard guard(&lock_, mode);
+    auto valid = true;
+    auto end   = false;
+    for (auto current = root_; valid && !end;) {
+      chunk.clear();
+      for (; chunk.size() < SCAN_CHUNK; current = current->next) {
+        if constexpr (Reclaimer::PROTECTS_POINTERS) {
+          reclaim_guard.Protect(0, current);
+          if (!(valid = guard.TryCheckOptimisticLock())) { break; }
+        }
+        if (current == nullptr || KeyTrait::Compare(current, hi_key, hi) >= 0) {
+          end = true;
+          break;
+        }
+        KeyTrait::Prefetch(current);
+        if (KeyTrait::Compare(current, lo_key, lo) >= 0 && (!resume || KeyTrait::Value(current) <=> *resume > 0)) {
+          chunk.push_back(KeyTrait::Value(current));
         }
       }
-       return found;
-    } catch (const RestartException &) {
-      //std::cout << "LookUp failed" << std::endl;
+      // Non-consuming check: on success `current` is still a valid position to continue from
+      if (!valid || !guard.TryCheckOptimisticLock()) {
+        valid = false;
+        break;
+      }
+      for (const auto &value : chunk) {
+        visited++;
+        resume = value;
+        if (!visit(value)) {
+          guard.Unlock();
+          restarts_.Record(attempt);
+          return visited;
+        }
+      }
+    }
+    if (valid) {
+      guard.Unlock();
+      restarts_.Record(attempt);
+      return visited;
     }
   }
 }
 
-template <typename T>
-auto OptimisticSortedList<T>::Delete(T value) -> bool {   
-  HybridGuard guard(&lock_, GuardMode::EXCLUSIVE);
+/* Copy-out version of Scan(), stops once `out` is full */
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+auto OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::Scan(const T &lo, const T &hi, std::span<T> out)
+    -> uint64_t {
+  if (out.empty()) { return 0; }
+  uint64_t copied = 0;
+  return Scan(lo, hi, [&](const T &value) {
+    out[copied++] = value;
+    return copied < out.size();
+  });
+}
+
+template <typename T, typename Alloc, typename Reclaimer, typename KeyTrait, typename Lock>
+auto OptimisticSortedList<T, Alloc, Reclaimer, KeyTrait, Lock>::Delete(T value) -> bool {   
+  Guard guard(&lock_, GuardMode::EXCLUSIVE);
+  decltype(auto) key = KeyTrait::Of(value);
+  typename KeyTrait::Window window;
   bool found = false;
-  Node<T> *prev = nullptr;
-  Node<T> *current;
+  NodeType *prev = nullptr;
+  NodeType *current;
   for (current = root_; current != nullptr; current = current->next) {
-    if (current->value <=> value > 0) { break; }
-    if (current->value <=> value == 0) {
+    KeyTrait::Prefetch(current);
+    auto order = KeyTrait::Compare(current, key, value);
+    if (order > 0) { break; }
+    if (order == 0) {
       found = true;
       if (prev == nullptr) {
         root_ = current->next;
       } else {
         prev->next = current->next;
       }
+      window.AfterDelete(current->next);
       break;
     }
     prev = current;
+    window.Push(current);
   }
 
   if(found){
     assert(current != nullptr);
-    epoch_->DeferFreePointer(thread_id, current);
+    reclaimer_->DeferFreePointer(thread_id, current, sizeof(*current), FreeNode);
   }
 
   return found;
 }
+
+template <typename T, typename Alloc, typename Reclaimer>
+LockCouplingSortedList<T, Alloc, Reclaimer>::LockCouplingSortedList(Reclaimer *reclaimer)
+    : reclaimer_(reclaimer) {}
+
+template <typename T, typename Alloc, typename Reclaimer>
+LockCouplingSortedList<T, Alloc, Reclaimer>::~LockCouplingSortedList() {
+  LatchedNode<T> *tmp;
+  for (; root_ != nullptr; root_ = tmp) {
+    tmp = root_->next;
+    FreeLatchedNode(root_, sizeof(*root_));
+  }
+}
+
+template <typename T, typename Alloc, typename Reclaimer>
+auto LockCouplingSortedList<T, Alloc, Reclaimer>::NewLatchedNode(T value, LatchedNode<T> *next) -> LatchedNode<T> * {
+  auto memory = Alloc::Allocate(sizeof(LatchedNode<T>));
+  return new (memory) LatchedNode<T>(value, next);
+}
+
+/* Deleter of retired nodes */
+template <typename T, typename Alloc, typename Reclaimer>
+void LockCouplingSortedList<T, Alloc, Reclaimer>::FreeLatchedNode(void *ptr, uint64_t size) {
+  static_cast<LatchedNode<T> *>(ptr)->~LatchedNode();
+  Alloc::Deallocate(ptr, size);
+}
+
+/**
+ * Publish `node` in a hazard slot, then check that it was still linked, i.e. that `owner` did not change since.
+ * Nothing to do when the reclaimer guard protects the whole traversal (EpochHandler)
+ */
+template <typename T, typename Alloc, typename Reclaimer>
+auto LockCouplingSortedList<T, Alloc, Reclaimer>::Protect(typename Reclaimer::Guard &guard, uint64_t slot,
+                                                          LatchedNode<T> *node, HybridGuard &owner) -> bool {
+  if constexpr (Reclaimer::PROTECTS_POINTERS) {
+    guard.Protect(slot, node);
+    return owner.TryCheckOptimisticLock();
+  }
+  return true;
+}
+
+/**
+ * Every traversal below follows the same coupling protocol:
+ * - `prev_guard` optimistically guards the node owning `*link` (root_lock_ for the head)
+ * - `current = *link` is protected before it is dereferenced (see Protect()),
+ *    the predecessor and the current node use alternating hazard slots
+ * - the guard of `current` is taken before `prev_guard` is validated,
+ *    so a successful validation proves that `current` was still linked when its version was read
+ * Node memory stays valid during the traversal thanks to the reclaimer guard, and the key of a node never changes,
+ *  so comparing against a node which is not guarded yet is fine.
+ * All three are exception-free: a failed validation or upgrade releases the remaining guards (none is left
+ *  optimistic, whose destructor would validate again) and restarts from the root
+ */
+template <typename T, typename Alloc, typename Reclaimer>
+void LockCouplingSortedList<T, Alloc, Reclaimer>::Insert(T value) {
+  while (true) {
+    typename Reclaimer::Guard reclaim_guard(reclaimer_, thread_id);
+    HybridGuard prev_guard(&root_lock_, GuardMode::OPTIMISTIC);
+    auto link = &root_;
+    auto slot = 0ULL;
+    while (true) {
+      auto current = *link;
+      if (!Protect(reclaim_guard, slot, current, prev_guard)) { break; }
+      if (current == nullptr || current->value <=> value > 0) {
+        if (!prev_guard.TryUpgradeToExclusive()) { break; }
+        *link = NewLatchedNode(value, current);
+        return;
+      }
+      HybridGuard current_guard(&current->lock, GuardMode::OPTIMISTIC);
+      if (current->value <=> value == 0) {
+        if (!current_guard.TryUpgradeToExclusive()) {
+          prev_guard.Unlock();
+          break;
+        }
+        if (!prev_guard.TryValidateOptimisticLock()) { break; }
+        current->value = value;
+        return;
+      }
+      if (!prev_guard.TryValidateOptimisticLock()) {
+        current_guard.Unlock();
+        break;
+      }
+      link       = &current->next;
+      prev_guard = std::move(current_guard);
+      slot ^= 1;
+    }
+  }
+}
+
+template <typename T, typename Alloc, typename Reclaimer>
+auto LockCouplingSortedList<T, Alloc, Reclaimer>::LookUp(T value, T &result) -> bool {
+  while (true) {
+    typename Reclaimer::Guard reclaim_guard(reclaimer_, thread_id);
+    HybridGuard prev_guard(&root_lock_, GuardMode::OPTIMISTIC);
+    auto link  = &root_;
+    auto slot  = 0ULL;
+    auto found = false;
+    auto valid = true;
+    while (true) {
+      auto current = *link;
+      if (current == nullptr) { break; }
+      if (!(valid = Protect(reclaim_guard, slot, current, prev_guard))) { break; }
+      HybridGuard current_guard(&current->lock, GuardMode::OPTIMISTIC);
+      valid = prev_guard.TryValidateOptimisticLock();
+      if (!valid) {
+        current_guard.Unlock();
+        break;
+      }
+      auto order = current->value <=> value;
+      if (order == 0) {
+        found  = true;
+        result = current->value;
+      }
+      // From here on `prev_guard` protects `current`: the final validation covers what was read above
+      prev_guard = std::move(current_guard);
+      if (order >= 0) { break; }
+      link = &current->next;
+      slot ^= 1;
+    }
+    if (valid && prev_guard.TryValidateOptimisticLock()) { return found; }
+  }
+}
+
+template <typename T, typename Alloc, typename Reclaimer>
+auto LockCouplingSortedList<T, Alloc, Reclaimer>::Delete(T value) -> bool {
+  while (true) {
+    typename Reclaimer::Guard reclaim_guard(reclaimer_, thread_id);
+    HybridGuard prev_guard(&root_lock_, GuardMode::OPTIMISTIC);
+    auto link = &root_;
+    auto slot = 0ULL;
+    while (true) {
+      auto current = *link;
+      if (current == nullptr) {
+        if (prev_guard.TryValidateOptimisticLock()) { return false; }
+        break;
+      }
+      if (!Protect(reclaim_guard, slot, current, prev_guard)) { break; }
+      HybridGuard current_guard(&current->lock, GuardMode::OPTIMISTIC);
+      auto order = current->value <=> value;
+      if (order > 0) {
+        current_guard.Unlock();
+        if (prev_guard.TryValidateOptimisticLock()) { return false; }
+        break;
+      }
+      if (order == 0) {
+        if (!prev_guard.TryUpgradeToExclusive()) {
+          current_guard.Unlock();
+          break;
+        }
+        if (!current_guard.TryUpgradeToExclusive()) { break; }
+        *link = current->next;
+        // Both versions are bumped on unlock, so concurrent readers on `current` restart
+        reclaimer_->DeferFreePointer(thread_id, current, sizeof(*current), FreeLatchedNode);
+        return true;
+      }
+      if (!prev_guard.TryValidateOptimisticLock()) {
+        current_guard.Unlock();
+        break;
+      }
+      link       = &current->next;
+      prev_guard = std::move(current_guard);
+      slot ^= 1;
+    }
+  }
+}
 }  // namespace FinalProject
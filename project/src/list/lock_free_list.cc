@@ -0,0 +1,125 @@
+#include "list/lock_free_list.h"
+#include <cstdlib>
+#include "common/utils.h"
+#include "sync/epoch.h"
+
+namespace FinalProject {
+
+template <typename T, typename Alloc>
+LockFreeSortedList<T, Alloc>::LockFreeSortedList(EpochHandler *ep) : epoch_(ep) {}
+
+/* Nodes which were already unlinked belong to the EpochHandler, everything reachable belongs to us */
+template <typename T, typename Alloc>
+LockFreeSortedList<T, Alloc>::~LockFreeSortedList() {
+  NodePtr tmp;
+  for (auto current = root_.load(); current != nullptr; current = tmp) {
+    tmp = Unmark(current->next.load());
+    FreeLockFreeNode(current, sizeof(*current));
+  }
+}
+
+template <typename T, typename Alloc>
+auto LockFreeSortedList<T, Alloc>::NewLockFreeNode(T value, NodePtr next) -> NodePtr {
+  auto memory = Alloc::Allocate(sizeof(LockFreeNode<T>));
+  return new (memory) LockFreeNode<T>(value, next);
+}
+
+/* Deleter of retired nodes */
+template <typename T, typename Alloc>
+void LockFreeSortedList<T, Alloc>::FreeLockFreeNode(void *ptr, uint64_t size) {
+  static_cast<LockFreeNode<T> *>(ptr)->~LockFreeNode();
+  Alloc::Deallocate(ptr, size);
+}
+
+/**
+ * Position `prev` and `current` such that `*prev == current` and `current` is the first node >= `value`.
+ * Marked nodes met on the way are unlinked and retired. Must be called under an EpochGuard
+ *
+ * Return true if `current` holds `value`
+ */
+template <typename T, typename Alloc>
+auto LockFreeSortedList<T, Alloc>::Find(const T &value, std::atomic<NodePtr> *&prev, NodePtr &current) -> bool {
+retry:
+  prev    = &root_;
+  current = prev->load();
+  while (current != nullptr) {
+    auto next = current->next.load();
+    if (IsMarked(next)) {
+      if (!prev->compare_exchange_strong(current, Unmark(next))) { goto retry; }
+      epoch_->DeferFreePointer(thread_id, current, sizeof(*current), FreeLockFreeNode);
+      current = Unmark(next);
+      continue;
+    }
+    if (current->value <=> value >= 0) { return current->value <=> value == 0; }
+    prev    = &current->next;
+    current = next;
+  }
+  return false;
+}
+
+/**
+ * An existing node is never written in place: the new node is published by marking the old node's `next`
+ *  with the new node, which deletes the old node and makes the new one reachable in one CAS
+ */
+template <typename T, typename Alloc>
+void LockFreeSortedList<T, Alloc>::Insert(T value) {
+  EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+  auto node = NewLockFreeNode(value, nullptr);
+  std::atomic<NodePtr> *prev;
+  NodePtr current;
+  while (true) {
+    if (!Find(value, prev, current)) {
+      node->next.store(current);
+      if (prev->compare_exchange_strong(current, node)) { return; }
+      continue;
+    }
+    auto next = current->next.load();
+    if (IsMarked(next)) { continue; }
+    node->next.store(next);
+    if (current->next.compare_exchange_strong(next, Mark(node))) {
+      if (prev->compare_exchange_strong(current, node)) {
+        epoch_->DeferFreePointer(thread_id, current, sizeof(*current), FreeLockFreeNode);
+      } else {
+        Find(value, prev, current);
+      }
+      return;
+    }
+  }
+}
+
+/* Marked nodes are skipped without helping, a marked node may be followed by its replacement */
+template <typename T, typename Alloc>
+auto LockFreeSortedList<T, Alloc>::LookUp(T value, T &result) -> bool {
+  EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+  for (auto current = root_.load(); current != nullptr;) {
+    auto next = current->next.load();
+    if (current->value <=> value > 0) { break; }
+    if (current->value <=> value == 0 && !IsMarked(next)) {
+      result = current->value;
+      return true;
+    }
+    current = Unmark(next);
+  }
+  return false;
+}
+
+template <typename T, typename Alloc>
+auto LockFreeSortedList<T, Alloc>::Delete(T value) -> bool {
+  EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+  std::atomic<NodePtr> *prev;
+  NodePtr current;
+  while (true) {
+    if (!Find(value, prev, current)) { return false; }
+    auto next = current->next.load();
+    if (IsMarked(next)) { continue; }
+    if (!current->next.compare_exchange_strong(next, Mark(next))) { continue; }
+    if (prev->compare_exchange_strong(current, next)) {
+      epoch_->DeferFreePointer(thread_id, current, sizeof(*current), FreeLockFreeNode);
+    } else {
+      Find(value, prev, current);
+    }
+    return true;
+  }
+}
+
+}  // namespace FinalProject
@@ -0,0 +1,203 @@
+#include "list/skip_list.h"
+#include <cstdlib>
+#include "common/utils.h"
+#include "sync/guard.h"
+#include "sync/wait.h"
+
+namespace FinalProject {
+
+template <typename T, typename Alloc>
+OptimisticSkipList<T, Alloc>::OptimisticSkipList(EpochHandler *ep) : epoch_(ep) {}
+
+template <typename T, typename Alloc>
+OptimisticSkipList<T, Alloc>::~OptimisticSkipList() {
+  SkipNode<T> *tmp;
+  for (auto current = head_[0]; current != nullptr; current = tmp) {
+    tmp = current->next[0];
+    FreeSkipNode(current, NodeSize(current->height));
+  }
+}
+
+template <typename T, typename Alloc>
+auto OptimisticSkipList<T, Alloc>::NewSkipNode(T value, uint8_t height) -> SkipNode<T> * {
+  auto memory = Alloc::Allocate(NodeSize(height));
+  return new (memory) SkipNode<T>(value, height);
+}
+
+/* Deleter of retired towers */
+template <typename T, typename Alloc>
+void OptimisticSkipList<T, Alloc>::FreeSkipNode(void *ptr, uint64_t size) {
+  static_cast<SkipNode<T> *>(ptr)->~SkipNode();
+  Alloc::Deallocate(ptr, size);
+}
+
+/* Geometric distribution with p = 1/4, xorshift state per thread */
+template <typename T, typename Alloc>
+auto OptimisticSkipList<T, Alloc>::RandomHeight() -> uint8_t {
+  thread_local uint64_t seed = reinterpret_cast<uint64_t>(&seed) | 1;
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  uint8_t height = 1;
+  for (auto bits = seed; height < MAX_HEIGHT && (bits & 3) == 0; bits >>= 2) { height++; }
+  return height;
+}
+
+/* State and version of `lock` once it is not exclusively locked, the writer-side OptimisticLock() */
+template <typename T, typename Alloc>
+auto OptimisticSkipList<T, Alloc>::StableVersion(HybridLock *lock) -> uint64_t {
+  auto state = lock->StateAndVersion().load();
+  for (Waiter waiter(WaitPolicy::Default()); HybridLock::LockState(state) == HybridLock::EXCLUSIVE;) {
+    if (waiter.Pause()) { lock->Park(state); }
+    state = lock->StateAndVersion().load();
+  }
+  return state;
+}
+
+/**
+ * Optimistic descent for writers: fill `pos` with the last tower < `value` on every level,
+ *  together with the version that tower had before its next pointers were read.
+ * Moving right validates the predecessor, the final predecessors are validated when they are locked
+ *
+ * Return the tower holding `value`, nullptr if there is none
+ */
+template <typename T, typename Alloc>
+auto OptimisticSkipList<T, Alloc>::Find(const T &value, Position &pos) -> SkipNode<T> * {
+  SkipNode<T> *pred  = nullptr;
+  SkipNode<T> *found = nullptr;
+  auto version       = StableVersion(&head_lock_);
+  for (int level = MAX_HEIGHT - 1; level >= 0; level--) {
+    auto current = NextOf(pred, level);
+    while (current != nullptr && current->value <=> value < 0) {
+      auto next_version = StableVersion(&current->lock);
+      if (LockOf(pred)->StateAndVersion().load() != version) { throw RestartException(); }
+      pred    = current;
+      version = next_version;
+      current = NextOf(pred, level);
+    }
+    if (found == nullptr && current != nullptr && current->value <=> value == 0) { found = current; }
+    pos.preds[level]    = pred;
+    pos.versions[level] = version;
+    pos.succs[level]    = current;
+  }
+  return found;
+}
+
+/**
+ * Exclusively lock the distinct predecessors of levels [0, height).
+ * A predecessor occupies a contiguous range of levels, so comparing neighbours is enough.
+ * Fail (and release everything) if any of them changed since Find()
+ */
+template <typename T, typename Alloc>
+auto OptimisticSkipList<T, Alloc>::LockPredecessors(Position &pos, uint8_t height) -> bool {
+  for (int level = 0; level < height; level++) {
+    if (level > 0 && pos.preds[level] == pos.preds[level - 1]) { continue; }
+    if (!LockOf(pos.preds[level])->TryLockExclusive(pos.versions[level])) {
+      UnlockPredecessors(pos, level);
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T, typename Alloc>
+void OptimisticSkipList<T, Alloc>::UnlockPredecessors(Position &pos, uint8_t height) {
+  for (int level = 0; level < height; level++) {
+    if (level > 0 && pos.preds[level] == pos.preds[level - 1]) { continue; }
+    LockOf(pos.preds[level])->UnlockExclusive();
+  }
+}
+
+template <typename T, typename Alloc>
+void OptimisticSkipList<T, Alloc>::Insert(T value) {
+  auto height = RandomHeight();
+  while (true) {
+    try {
+      EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+      Position pos;
+      auto found = Find(value, pos);
+      if (found != nullptr) {
+        // Still linked on level 0 <=> its level-0 predecessor did not change since Find()
+        auto version = StableVersion(&found->lock);
+        if (LockOf(pos.preds[0])->StateAndVersion().load() != pos.versions[0]) { throw RestartException(); }
+        if (!found->lock.TryLockExclusive(version)) { throw RestartException(); }
+        found->value = value;
+        found->lock.UnlockExclusive();
+        return;
+      }
+      if (!LockPredecessors(pos, height)) { throw RestartException(); }
+      auto node = NewSkipNode(value, height);
+      for (int level = 0; level < height; level++) {
+        node->next[level]               = pos.succs[level];
+        NextOf(pos.preds[level], level) = node;
+      }
+      UnlockPredecessors(pos, height);
+      return;
+    } catch (const RestartException &) {}
+  }
+}
+
+/* Exception-free: a failed validation drops the remaining guards and restarts from the head */
+template <typename T, typename Alloc>
+auto OptimisticSkipList<T, Alloc>::LookUp(T value, T &result) -> bool {
+  while (true) {
+    EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+    SkipNode<T> *pred = nullptr;
+    HybridGuard pred_guard(&head_lock_, GuardMode::OPTIMISTIC);
+    auto found = false;
+    auto valid = true;
+    for (int level = MAX_HEIGHT - 1; valid && !found && level >= 0; level--) {
+      auto current = NextOf(pred, level);
+      while (current != nullptr && current->value <=> value <= 0) {
+        HybridGuard current_guard(&current->lock, GuardMode::OPTIMISTIC);
+        valid = pred_guard.TryValidateOptimisticLock();
+        if (!valid) {
+          current_guard.Unlock();
+          break;
+        }
+        pred_guard = std::move(current_guard);
+        pred       = current;
+        if (current->value <=> value == 0) {
+          found  = true;
+          result = current->value;
+          break;
+        }
+        current = NextOf(pred, level);
+      }
+    }
+    if (valid && pred_guard.TryValidateOptimisticLock()) { return found; }
+  }
+}
+
+template <typename T, typename Alloc>
+auto OptimisticSkipList<T, Alloc>::Delete(T value) -> bool {
+  while (true) {
+    try {
+      EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+      Position pos;
+      auto victim = Find(value, pos);
+      if (victim == nullptr) {
+        if (LockOf(pos.preds[0])->StateAndVersion().load() != pos.versions[0]) { throw RestartException(); }
+        return false;
+      }
+      auto height = victim->height;
+      for (int level = 0; level < height; level++) {
+        if (pos.succs[level] != victim) { throw RestartException(); }
+      }
+      auto version = StableVersion(&victim->lock);
+      if (!LockPredecessors(pos, height)) { throw RestartException(); }
+      if (!victim->lock.TryLockExclusive(version)) {
+        UnlockPredecessors(pos, height);
+        throw RestartException();
+      }
+      for (int level = 0; level < height; level++) { NextOf(pos.preds[level], level) = victim->next[level]; }
+      // Bump the victim's version as well, readers standing on it restart
+      victim->lock.UnlockExclusive();
+      UnlockPredecessors(pos, height);
+      epoch_->DeferFreePointer(thread_id, victim, NodeSize(height), FreeSkipNode);
+      return true;
+    } catch (const RestartException &) {}
+  }
+}
+
+}  // namespace FinalProject
@@ -0,0 +1,250 @@
+#include "list/unrolled_list.h"
+#include <algorithm>
+#include "common/utils.h"
+#include "sync/guard.h"
+
+namespace FinalProject {
+
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+UnrolledSortedList<T, CHUNK_SIZE, Alloc>::UnrolledSortedList(EpochHandler *ep) : epoch_(ep) {}
+
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+UnrolledSortedList<T, CHUNK_SIZE, Alloc>::~UnrolledSortedList() {
+  Chunk *tmp;
+  for (; head_ != nullptr; head_ = tmp) {
+    tmp = head_->next;
+    FreeChunk(head_, sizeof(Chunk));
+  }
+}
+
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+auto UnrolledSortedList<T, CHUNK_SIZE, Alloc>::NewChunk() -> Chunk * {
+  auto memory = Alloc::Allocate(sizeof(Chunk));
+  return new (memory) Chunk();
+}
+
+/* Deleter of retired chunks */
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+void UnrolledSortedList<T, CHUNK_SIZE, Alloc>::FreeChunk(void *ptr, uint64_t size) {
+  static_cast<Chunk *>(ptr)->~Chunk();
+  Alloc::Deallocate(ptr, size);
+}
+
+/* `count` of a chunk read optimistically: a torn value must not send the search out of bounds */
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+auto UnrolledSortedList<T, CHUNK_SIZE, Alloc>::Count(Chunk *chunk) -> uint32_t {
+  return std::min<uint32_t>(chunk->count, Chunk::MAX_ENTRIES);
+}
+
+/* Whether `value` belongs to `chunk`, `next` being the successor read under the same guard */
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+auto UnrolledSortedList<T, CHUNK_SIZE, Alloc>::IsTarget(Chunk *chunk, Chunk *next, const T &value) -> bool {
+  if (next == nullptr) { return true; }
+  auto count = Count(chunk);
+  return count == 0 || chunk->values[count - 1] <=> value >= 0;
+}
+
+/**
+ * Move the upper half of `chunk` into a new successor.
+ * The successor is only reachable through `chunk`, so holding `chunk` exclusively covers both
+ */
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+void UnrolledSortedList<T, CHUNK_SIZE, Alloc>::Split(Chunk *chunk) {
+  auto sibling = NewChunk();
+  uint32_t mid = chunk->count / 2;
+  std::copy(chunk->values + mid, chunk->values + chunk->count, sibling->values);
+  sibling->count = chunk->count - mid;
+  sibling->next  = chunk->next;
+  chunk->count   = mid;
+  chunk->next    = sibling;
+}
+
+/**
+ * Absorb the successor of `chunk` if both fit in three quarters of a chunk, so that the merged chunk
+ *  does not split again right away. Caller must hold `chunk` exclusively.
+ * Locks are always taken in list order (predecessor first), so waiting for the successor cannot deadlock
+ */
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+void UnrolledSortedList<T, CHUNK_SIZE, Alloc>::MergeNext(Chunk *chunk) {
+  auto next = chunk->next;
+  if (next == nullptr) { return; }
+  HybridGuard next_guard(&next->lock, GuardMode::EXCLUSIVE);
+  if (chunk->count + next->count > Chunk::MAX_ENTRIES * 3 / 4) { return; }
+  std::copy(next->values, next->values + next->count, chunk->values + chunk->count);
+  chunk->count += next->count;
+  chunk->next = next->next;
+  // Bumps the version of `next`, readers standing on it restart
+  next_guard.Unlock();
+  epoch_->DeferFreePointer(thread_id, next, sizeof(Chunk), FreeChunk);
+}
+
+/**
+ * Insert and Delete share the descent of LockCouplingSortedList:
+ * - `prev_guard` optimistically guards the owner of `*link` (head_lock_ for the first chunk)
+ * - the successor is read and checked before it is dereferenced,
+ *    and its guard is taken before the current chunk is validated (via the guard move)
+ * The target chunk is then upgraded: a successful upgrade proves that it is still linked,
+ *  since unlinking a chunk bumps its version as well
+ */
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+void UnrolledSortedList<T, CHUNK_SIZE, Alloc>::Insert(T value) {
+  while (true) {
+    try {
+      EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+      HybridGuard prev_guard(&head_lock_, GuardMode::OPTIMISTIC);
+      auto chunk = head_;
+      if (chunk == nullptr) {
+        prev_guard.UpgradeToExclusive();
+        auto first       = NewChunk();
+        first->values[0] = value;
+        first->count     = 1;
+        head_            = first;
+        return;
+      }
+      prev_guard.CheckOptimisticLock();
+      HybridGuard chunk_guard(&chunk->lock, GuardMode::OPTIMISTIC);
+      for (auto next = chunk->next; !IsTarget(chunk, next, value); next = chunk->next) {
+        chunk_guard.CheckOptimisticLock();
+        HybridGuard next_guard(&next->lock, GuardMode::OPTIMISTIC);
+        prev_guard  = std::move(chunk_guard);
+        chunk_guard = std::move(next_guard);
+        chunk       = next;
+      }
+
+      chunk_guard.UpgradeToExclusive();
+      prev_guard.ValidateOptimisticLock();
+      auto pos = KeyLowerBound(chunk->values, chunk->count, value);
+      if (pos < chunk->count && chunk->values[pos] <=> value == 0) {
+        chunk->values[pos] = value;
+        return;
+      }
+      if (chunk->count == Chunk::MAX_ENTRIES) {
+        Split(chunk);
+        if (pos > chunk->count) {
+          pos -= chunk->count;
+          chunk = chunk->next;
+        }
+      }
+      std::copy_backward(chunk->values + pos, chunk->values + chunk->count, chunk->values + chunk->count + 1);
+      chunk->values[pos] = value;
+      chunk->count++;
+      return;
+    } catch (const RestartException &) {}
+  }
+}
+
+/* Exception-free: a failed validation drops the remaining guard and restarts from the head */
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+auto UnrolledSortedList<T, CHUNK_SIZE, Alloc>::LookUp(T value, T &result) -> bool {
+  while (true) {
+    EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+    HybridGuard guard(&head_lock_, GuardMode::OPTIMISTIC);
+    Chunk *chunk = nullptr;
+    auto next    = head_;
+    auto valid   = true;
+    // `guard` protects `chunk` (the head for nullptr), `next` is read under it
+    while (next != nullptr && (chunk == nullptr || !IsTarget(chunk, next, value))) {
+      if (!(valid = guard.TryCheckOptimisticLock())) { break; }
+      HybridGuard next_guard(&next->lock, GuardMode::OPTIMISTIC);
+      if (!(valid = guard.TryValidateOptimisticLock())) {
+        next_guard.Unlock();
+        break;
+      }
+      guard = std::move(next_guard);
+      chunk = next;
+      next  = chunk->next;
+    }
+    if (!valid) { continue; }
+
+    auto found = false;
+    if (chunk != nullptr) {
+      auto count = Count(chunk);
+      auto pos   = KeyLowerBound(chunk->values, count, value);
+      found      = pos < count && chunk->values[pos] <=> value == 0;
+      if (found) { result = chunk->values[pos]; }
+    }
+    if (guard.TryValidateOptimisticLock()) { return found; }
+  }
+}
+
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+auto UnrolledSortedList<T, CHUNK_SIZE, Alloc>::Delete(T value) -> bool {
+  while (true) {
+    try {
+      EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+      HybridGuard prev_guard(&head_lock_, GuardMode::OPTIMISTIC);
+      auto link  = &head_;
+      auto chunk = *link;
+      if (chunk == nullptr) {
+        prev_guard.ValidateOptimisticLock();
+        return false;
+      }
+      prev_guard.CheckOptimisticLock();
+      HybridGuard chunk_guard(&chunk->lock, GuardMode::OPTIMISTIC);
+      for (auto next = chunk->next; !IsTarget(chunk, next, value); next = chunk->next) {
+        chunk_guard.CheckOptimisticLock();
+        HybridGuard next_guard(&next->lock, GuardMode::OPTIMISTIC);
+        prev_guard  = std::move(chunk_guard);
+        chunk_guard = std::move(next_guard);
+        link        = &chunk->next;
+        chunk       = next;
+      }
+
+      auto count = Count(chunk);
+      auto pos   = KeyLowerBound(chunk->values, count, value);
+      if (pos == count || chunk->values[pos] <=> value != 0) {
+        chunk_guard.ValidateOptimisticLock();
+        prev_guard.ValidateOptimisticLock();
+        return false;
+      }
+      if (count == 1) {
+        // Last value of the chunk: unlink it, the successor takes over its key range
+        prev_guard.UpgradeToExclusive();
+        chunk_guard.UpgradeToExclusive();
+        *link = chunk->next;
+        epoch_->DeferFreePointer(thread_id, chunk, sizeof(Chunk), FreeChunk);
+        return true;
+      }
+      chunk_guard.UpgradeToExclusive();
+      prev_guard.ValidateOptimisticLock();
+      std::copy(chunk->values + pos + 1, chunk->values + chunk->count, chunk->values + pos);
+      chunk->count--;
+      if (chunk->count < Chunk::MAX_ENTRIES / 4) { MergeNext(chunk); }
+      return true;
+    } catch (const RestartException &) {}
+  }
+}
+
+/* Same coupling as LookUp(), a failed validation restarts the whole scan */
+template <typename T, uint64_t CHUNK_SIZE, typename Alloc>
+auto UnrolledSortedList<T, CHUNK_SIZE, Alloc>::Scan(const T &lo, const T &hi, std::span<T> out) -> uint64_t {
+  if (out.empty()) { return 0; }
+  while (true) {
+    EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+    HybridGuard guard(&head_lock_, GuardMode::OPTIMISTIC);
+    uint64_t copied = 0;
+    auto valid      = true;
+    auto end        = false;
+    for (auto chunk = head_; chunk != nullptr && !end;) {
+      if (!(valid = guard.TryCheckOptimisticLock())) { break; }
+      HybridGuard chunk_guard(&chunk->lock, GuardMode::OPTIMISTIC);
+      if (!(valid = guard.TryValidateOptimisticLock())) {
+        chunk_guard.Unlock();
+        break;
+      }
+      guard = std::move(chunk_guard);
+
+      auto count = Count(chunk);
+      // Once something was copied, every later value is >= lo
+      auto pos = (copied == 0) ? KeyLowerBound(chunk->values, count, lo) : 0;
+      for (; pos < count && chunk->values[pos] <=> hi < 0 && copied < out.size(); pos++) {
+        out[copied++] = chunk->values[pos];
+      }
+      end   = pos < count || copied == out.size();
+      chunk = chunk->next;
+    }
+    if (valid && guard.TryValidateOptimisticLock()) { return copied; }
+  }
+}
+
+}  // namespace FinalProject
\ No newline at end of file
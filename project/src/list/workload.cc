@@ -0,0 +1,193 @@
+#include "list/workload.h"
+#include "common/utils.h"
+#include "sync/wait.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace FinalProject {
+
+namespace {
+
+constexpr uint64_t STREAM_LENGTH = 1 << 16;  // Operations pre-generated per worker, replayed in a loop
+
+/* With LATEST, `key` is the distance to the latest inserted key, resolved when the operation runs */
+struct Operation {
+  WorkloadOp kind;
+  uint64_t key;
+};
+
+/* Padded so that the workers do not share a cache line while counting */
+struct alignas(64) WorkerResult {
+  std::array<uint64_t, static_cast<uint32_t>(WorkloadOp::COUNT)> ops{};
+  std::array<LatencyHistogram, static_cast<uint32_t>(WorkloadOp::COUNT)> latencies{};
+};
+
+/* Spread the popular zipfian ranks over the key space instead of packing them at the head of the list */
+auto Scramble(uint64_t rank) -> uint64_t {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (auto byte = 0; byte < 8; byte++) {
+    hash ^= (rank >> (byte * 8)) & 0xff;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+auto GenerateStream(const WorkloadConfig &config, uint32_t worker) -> std::vector<Operation> {
+  std::mt19937_64 rng(42 + worker);
+  std::uniform_int_distribution<uint64_t> uniform(0, config.keys - 1);
+  ZipfianGenerator zipfian(config.keys, config.zipf_theta);
+  auto total = std::max(1U, config.lookups + config.inserts + config.deletes + config.scans);
+  std::uniform_int_distribution<uint32_t> roll(0, total - 1);
+
+  std::vector<Operation> stream(STREAM_LENGTH);
+  for (auto &op : stream) {
+    auto weight = roll(rng);
+    if (weight < config.lookups) {
+      op.kind = WorkloadOp::LOOKUP;
+    } else if (weight < config.lookups + config.inserts) {
+      op.kind = WorkloadOp::INSERT;
+    } else if (weight < config.lookups + config.inserts + config.deletes) {
+      op.kind = WorkloadOp::DELETE;
+    } else {
+      op.kind = WorkloadOp::SCAN;
+    }
+    switch (config.distribution) {
+      case KeyDistribution::UNIFORM: op.key = uniform(rng); break;
+      case KeyDistribution::ZIPFIAN: op.key = Scramble(zipfian.Next(rng)) % config.keys; break;
+      case KeyDistribution::LATEST: op.key = zipfian.Next(rng); break;
+    }
+  }
+  return stream;
+}
+
+}  // namespace
+
+auto WorkloadConfig::Preset(char name) -> WorkloadConfig {
+  WorkloadConfig config;
+  switch (name) {
+    case 'a': config = {50, 50, 0, 0, KeyDistribution::ZIPFIAN}; break;
+    case 'b': config = {95, 5, 0, 0, KeyDistribution::ZIPFIAN}; break;
+    case 'c': config = {100, 0, 0, 0, KeyDistribution::ZIPFIAN}; break;
+    case 'd': config = {95, 5, 0, 0, KeyDistribution::LATEST}; break;
+    case 'e': config = {0, 5, 0, 95, KeyDistribution::ZIPFIAN}; break;
+    default: throw std::invalid_argument("Unknown workload preset");
+  }
+  return config;
+}
+
+auto WorkloadResult::TotalOps() const -> uint64_t {
+  uint64_t total = 0;
+  for (auto count : ops) { total += count; }
+  return total;
+}
+
+auto WorkloadResult::Name(WorkloadOp op) -> const char * {
+  switch (op) {
+    case WorkloadOp::LOOKUP: return "lookup";
+    case WorkloadOp::INSERT: return "insert";
+    case WorkloadOp::DELETE: return "delete";
+    case WorkloadOp::SCAN: return "scan";
+    default: return "unknown";
+  }
+}
+
+ZipfianGenerator::ZipfianGenerator(uint64_t n, double theta)
+    : n_(std::max<uint64_t>(n, 1)), theta_(theta), alpha_(1 / (1 - theta)), zeta_n_(0) {
+  for (auto idx = 1UL; idx <= n_; idx++) { zeta_n_ += 1 / std::pow(idx, theta_); }
+  auto zeta_2 = 1 + 1 / std::pow(2, theta_);
+  eta_        = (1 - std::pow(2.0 / n_, 1 - theta_)) / (1 - zeta_2 / zeta_n_);
+}
+
+auto ZipfianGenerator::Next(std::mt19937_64 &rng) -> uint64_t {
+  auto u  = std::uniform_real_distribution<double>(0, 1)(rng);
+  auto uz = u * zeta_n_;
+  if (uz < 1) { return 0; }
+  if (uz < 1 + std::pow(0.5, theta_)) { return std::min<uint64_t>(1, n_ - 1); }
+  return std::min<uint64_t>(n_ * std::pow(eta_ * u - eta_ + 1, alpha_), n_ - 1);
+}
+
+/* Descending order, so that every insert into a sorted list stops at the head */
+void LoadWorkload(SortedList<uint64_t> &list, const WorkloadConfig &config) {
+  for (auto key = (config.keys - 1) & ~1UL;; key -= 2) {
+    list.Insert(key);
+    if (key < 2) { break; }
+  }
+}
+
+auto RunWorkload(SortedList<uint64_t> &list, const WorkloadConfig &config) -> WorkloadResult {
+  // Fail before any thread is started if the list has no Scan()
+  if (config.scans > 0) { list.Scan(0, 0, {}); }
+
+  std::vector<std::vector<Operation>> streams;
+  for (auto idx = 0U; idx < config.threads; idx++) { streams.push_back(GenerateStream(config, idx)); }
+  std::vector<WorkerResult> results(config.threads);
+  std::atomic<uint64_t> latest{config.keys};  // Next key appended by a LATEST insert
+  std::atomic<uint32_t> ready{0};
+  std::atomic<bool> start{false};
+  std::atomic<bool> stop{false};
+
+  // Opened before the workers are spawned, so that they inherit the counters
+  PerfEvent perf;
+  std::vector<std::thread> threads;
+  for (auto idx = 0U; idx < config.threads; idx++) {
+    threads.emplace_back([&, tid = idx]() {
+      InitializeThread();
+      auto &stream    = streams[tid];
+      auto &ops       = results[tid].ops;
+      auto &latencies = results[tid].latencies;
+      std::vector<uint64_t> scan_buffer(config.scan_length);
+      uint64_t result;
+      ready++;
+      while (!start.load()) { CpuPause(); }
+      for (auto pos = 0UL; !stop.load(std::memory_order_relaxed); pos = (pos + 1) % STREAM_LENGTH) {
+        auto &op = stream[pos];
+        auto key = op.key;
+        if (config.distribution == KeyDistribution::LATEST) {
+          key = (op.kind == WorkloadOp::INSERT) ? latest.fetch_add(1, std::memory_order_relaxed)
+                                                : latest.load(std::memory_order_relaxed) - 1 - op.key;
+        }
+        auto start_ns = config.record_latency ? NowNs() : 0;
+        switch (op.kind) {
+          case WorkloadOp::LOOKUP: list.LookUp(key, result); break;
+          case WorkloadOp::INSERT: list.Insert(key); break;
+          case WorkloadOp::DELETE: list.Delete(key); break;
+          case WorkloadOp::SCAN: list.Scan(key, key + config.scan_length, scan_buffer); break;
+          default: break;
+        }
+        if (config.record_latency) { latencies[static_cast<uint32_t>(op.kind)].Record(NowNs() - start_ns); }
+        ops[static_cast<uint32_t>(op.kind)]++;
+      }
+    });
+  }
+  while (ready.load() < config.threads) { std::this_thread::yield(); }
+
+  auto stats_before = Stats::Snapshot();
+  perf.StartCounters();
+  start.store(true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(config.duration_ms));
+  stop.store(true);
+  for (auto &thread : threads) { thread.join(); }
+  perf.StopCounters();
+
+  WorkloadResult workload;
+  workload.seconds = perf.Seconds();
+  workload.stats   = Stats::Snapshot() - stats_before;
+  for (auto idx = 0U; idx < PerfEvent::NO_EVENTS; idx++) {
+    workload.counters[idx] = perf.Value(static_cast<PerfEvent::Event>(idx));
+  }
+  for (auto &worker : results) {
+    for (auto idx = 0U; idx < worker.ops.size(); idx++) {
+      workload.ops[idx] += worker.ops[idx];
+      workload.latencies[idx].Merge(worker.latencies[idx]);
+    }
+  }
+  return workload;
+}
+
+}  // namespace FinalProject
\ No newline at end of file
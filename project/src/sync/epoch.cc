@@ -1,60 +1,170 @@
 #include "sync/epoch.h"
 
+#include <algorithm>
+
 namespace FinalProject {
 
-EpochHandler::EpochHandler(uint64_t no_threads)
-    : no_threads(std::min(no_threads, MAX_NUMBER_OF_WORKER)),
-      global_epoch(0),
-      local_epoch(this->no_threads),
-      to_free_ptr(this->no_threads) {}
+EpochHandler::EpochHandler(uint64_t no_threads) : global_epoch(0), records_(no_threads) {}
 
 /* Make sure to delete all remaining un-freed pointers */
 EpochHandler::~EpochHandler() {
+  StopReclaimer();
   /* Free existing to_free pointers */
-  for (auto &ptr_list : to_free_ptr) {
-    for (auto &[ptr, epoch] : ptr_list) { free(ptr); }
-  }
+  records_.ForEach([](ThreadRecord &record) {
+    for (auto &retired : record.to_free_ptr) { retired.Free(); }
+  });
+  for (auto &retired : limbo_) { retired.Free(); }
 }
 
 /**
  * Atomic increase the global epoch
  */
-void EpochHandler::AdvanceGlobalEpoch() { global_epoch.fetch_add(1); }
+void EpochHandler::AdvanceGlobalEpoch() {
+  Stats::Add(Counter::EPOCH_ADVANCES);
+  global_epoch.fetch_add(1);
+}
+
+/**
+ * Scan all allocated records. A record without an active guard holds MAX_VALUE,
+ *  so the result is the global epoch at worst once every thread left
+ */
+auto EpochHandler::MinEpoch() -> uint64_t {
+  auto min_epoch = global_epoch.load();
+  records_.ForEach([&](ThreadRecord &record) { min_epoch = std::min(min_epoch, record.local_epoch.load()); });
+  cached_min_epoch_.store(min_epoch);
+  return min_epoch;
+}
 
 /**
  * Execute the epoch-based memory reclaimation
  *
- * 1. Take the minimum epoch of all threads - called "min_epoch"
- * 2. Go through all to-be-freed ptr of `tid` (to_free_ptr[tid]):
+ * 1. Take the minimum epoch of all threads - called "min_epoch".
+ *    The cached value is reused unless it is too old to free anything
+ * 2. Go through all to-be-freed ptr of `tid` (ToFreePtr(tid)):
  *    Free all pointers whose epoch is < `min_epoch`
  */
 void EpochHandler::FreeOutdatedPtr(uint64_t tid) {
-  auto min_epoch = MAX_VALUE;
-  for (const auto &epoch : local_epoch) { min_epoch = std::min(min_epoch, epoch.load()); }
-  auto idx = 0ULL;
-  for (; idx < to_free_ptr[tid].size(); idx++) {
-    auto &[ptr, epoch] = to_free_ptr[tid][idx];
-    if (epoch >= min_epoch) { break; }
-    free(ptr);
+  auto &record = records_[tid];
+  std::lock_guard guard(record.to_free_lock);
+  if (record.to_free_ptr.empty()) { return; }
+  auto min_epoch = cached_min_epoch_.load();
+  if (record.to_free_ptr.front().epoch >= min_epoch) { min_epoch = MinEpoch(); }
+  auto idx       = 0ULL;
+  for (; idx < record.to_free_ptr.size(); idx++) {
+    auto &retired = record.to_free_ptr[idx];
+    if (retired.epoch >= min_epoch) { break; }
+    record.to_free_bytes -= retired.size;
+    retired.Free();
   }
-  to_free_ptr[tid].erase(to_free_ptr[tid].begin(), to_free_ptr[tid].begin() + idx);
+  record.to_free_ptr.erase(record.to_free_ptr.begin(), record.to_free_ptr.begin() + idx);
 }
 
 /**
- * Append the ptr to `to_free_ptr[tid]`, set its usable epoch to
- * local_epoch[tid]
+ * Append the ptr to `ToFreePtr(tid)`, set its usable epoch to the current global epoch:
+ *  every reader which may still see `ptr` has a local epoch <= that value.
+ * `size` drives the reclaimer cadence and is passed to `deleter`, it can be 0 if unknown and `deleter` is free()
  */
-void EpochHandler::DeferFreePointer(uint64_t tid, void *ptr) {
-  to_free_ptr[tid].emplace_back(ptr, local_epoch[tid].load());
+void EpochHandler::DeferFreePointer(uint64_t tid, void *ptr, uint64_t size, Deleter deleter) {
+  auto &record = records_[tid];
+  uint64_t pending;
+  {
+    std::lock_guard guard(record.to_free_lock);
+    record.to_free_ptr.emplace_back(ptr, global_epoch.load(), size, deleter);
+    pending = (record.to_free_bytes += size);
+  }
+  if (pending >= wake_threshold_.load(std::memory_order_relaxed)) { reclaimer_cv_.notify_one(); }
+}
+
+/**
+ * Start a thread which periodically advances the global epoch and frees retired pointers in batches,
+ *  so that workers never have to call FreeOutdatedPtr() themselves
+ */
+void EpochHandler::StartReclaimer(const ReclaimerConfig &config) {
+  if (reclaimer_.joinable()) { return; }
+  config_ = config;
+  stop_   = false;
+  wake_threshold_.store(config.retired_bytes_threshold);
+  reclaimer_ = std::thread([this]() { ReclaimerLoop(); });
+}
+
+void EpochHandler::StopReclaimer() {
+  if (!reclaimer_.joinable()) { return; }
+  {
+    std::lock_guard guard(reclaimer_mutex_);
+    stop_ = true;
+  }
+  reclaimer_cv_.notify_one();
+  reclaimer_.join();
+  wake_threshold_.store(MAX_VALUE);
+}
+
+/**
+ * One round of the reclaimer:
+ * 1. Advance the global epoch, so that new readers can be told apart from the old ones
+ * 2. Steal the retire list of every worker (a swap, the worker's lock is held for O(1))
+ * 3. Free everything in the limbo list which is older than the minimum local epoch
+ */
+void EpochHandler::ReclaimerLoop() {
+  std::vector<ToFreePointer> batch;
+  std::unique_lock lock(reclaimer_mutex_);
+  while (!stop_) {
+    reclaimer_cv_.wait_for(lock, config_.period);
+    lock.unlock();
+
+    AdvanceGlobalEpoch();
+    records_.ForEach([&](ThreadRecord &record) {
+      {
+        std::lock_guard guard(record.to_free_lock);
+        if (record.to_free_ptr.empty()) { return; }
+        std::swap(batch, record.to_free_ptr);
+        record.to_free_bytes = 0;
+      }
+      for (auto &retired : batch) { limbo_bytes_ += retired.size; }
+      limbo_.insert(limbo_.end(), batch.begin(), batch.end());
+      batch.clear();
+    });
+
+    auto min_epoch = MinEpoch();
+    auto freed =
+        std::partition(limbo_.begin(), limbo_.end(), [&](const auto &retired) { return retired.epoch >= min_epoch; });
+    for (auto it = freed; it != limbo_.end(); it++) {
+      limbo_bytes_ -= it->size;
+      it->Free();
+    }
+    limbo_.erase(freed, limbo_.end());
+
+    lock.lock();
+  }
+}
+
+/**
+ * Number of bytes retired but not yet freed, across all workers and the reclaimer
+ */
+auto EpochHandler::RetiredBytes() -> uint64_t {
+  auto total = limbo_bytes_.load();
+  records_.ForEach([&](ThreadRecord &record) {
+    std::lock_guard guard(record.to_free_lock);
+    total += record.to_free_bytes;
+  });
+  return total;
 }
 
 /**
  * - Set `epoch_` to the `local_epoch` of current thread id
  * - Update the `local_epoch` value to `global_epoch`
+ *
+ * The store is retried until the global epoch is stable around it, otherwise a concurrent MinEpoch()
+ *  could miss this thread and return a minimum larger than its epoch (the minimum must never decrease)
  */
 EpochGuard::EpochGuard(std::atomic<uint64_t> *local_epoch, const std::atomic<uint64_t> &global_epoch)
     : epoch_(local_epoch) {
-  epoch_->store(global_epoch.load());
+  auto epoch = global_epoch.load();
+  while (true) {
+    epoch_->store(epoch);
+    auto latest = global_epoch.load();
+    if (latest == epoch) { break; }
+    epoch = latest;
+  }
 }
 
 /**
@@ -62,4 +172,4 @@ EpochGuard::EpochGuard(std::atomic<uint64_t> *local_epoch, const std::atomic<uin
  */
 EpochGuard::~EpochGuard() { epoch_->store(EpochHandler::MAX_VALUE); }
 
-}  // namespace FinalProject
+}  // namespace FinalProject
\ No newline at end of file
@@ -1,52 +1,88 @@
 #include "sync/guard.h"
 #include "common/utils.h"
 
+#include <exception>
 #include <stdexcept>
 #include <thread>
 
 namespace FinalProject {
 
-HybridGuard::HybridGuard(HybridLock *lock, GuardMode mode) : lock_(lock), mode_(mode) {
+template <typename Lock>
+BasicHybridGuard<Lock>::BasicHybridGuard(Lock *lock, GuardMode mode)
+    : BasicHybridGuard(lock, mode, WaitPolicy::Default()) {}
+
+template <typename Lock>
+BasicHybridGuard<Lock>::BasicHybridGuard(Lock *lock, GuardMode mode, const WaitPolicy &policy)
+    : lock_(lock), mode_(mode), policy_(policy) {
+  timer_.Start();
   switch (mode) {
     case GuardMode::OPTIMISTIC: OptimisticLock(); break;
     case GuardMode::SHARED: {
+      Stats::Add(Counter::SHARED_ACQUISITIONS);
       uint64_t old_state;
-      for (auto counter = 0;; counter++) {
+      for (Waiter waiter(policy);;) {
         old_state = lock->StateAndVersion();
         if (lock->TryLockShared(old_state)) { break; }
-        std::this_thread::yield();
+        if (!waiter.Pause()) { continue; }
+        /* Only the last reader wakes parked waiters: park behind a writer, retry behind readers (MAX_SHARED) */
+        if (Lock::LockState(old_state) == Lock::EXCLUSIVE) {
+          lock->Park(old_state);
+        } else {
+          std::this_thread::yield();
+        }
       }
     } break;
     case GuardMode::EXCLUSIVE: {
+      Stats::Add(Counter::EXCLUSIVE_ACQUISITIONS);
       uint64_t old_state;
-      for (auto counter = 0;; counter++) {
+      for (Waiter waiter(policy);;) {
         old_state = lock->StateAndVersion();
         if (lock->TryLockExclusive(old_state)) { break; }
-        std::this_thread::yield();
+        if (waiter.Pause()) { lock->Park(old_state); }
       }
     } break;
     default: throw std::logic_error("Please no");
   }
 }
 
-
-auto HybridGuard::operator=(HybridGuard &&other) noexcept(false) -> HybridGuard & {
-  if (this->mode_ == GuardMode::OPTIMISTIC) { this->ValidateOptimisticLock(); }
-  this->lock_  = other.lock_;
-  this->mode_  = other.mode_;
-  this->state_ = other.state_;
+/**
+ * Release (or validate) the currently held lock and take over the lock of `other`.
+ * `other` is left in MOVED mode so that its destructor becomes a no-op
+ */
+template <typename Lock>
+auto BasicHybridGuard<Lock>::operator=(BasicHybridGuard &&other) noexcept(false) -> BasicHybridGuard & {
+  if (this->mode_ == GuardMode::OPTIMISTIC) {
+    this->ValidateOptimisticLock();
+  } else {
+    this->Unlock();
+  }
+  this->lock_   = other.lock_;
+  this->mode_   = other.mode_;
+  this->state_  = other.state_;
+  this->policy_ = other.policy_;
+  this->timer_  = other.timer_;
+  other.mode_   = GuardMode::MOVED;
   return *this;
 }
 
-HybridGuard::~HybridGuard() noexcept(false) {
+/**
+ * Validation is skipped while the stack is unwinding: a restart is already in flight,
+ *  and a second exception would terminate the program
+ */
+template <typename Lock>
+BasicHybridGuard<Lock>::~BasicHybridGuard() noexcept(false) {
   switch (mode_) {
-    case GuardMode::OPTIMISTIC: ValidateOptimisticLock(); break;
+    case GuardMode::OPTIMISTIC:
+      if (std::uncaught_exceptions() == 0) { ValidateOptimisticLock(); }
+      break;
     default: Unlock(); break;
   }
 }
 
-void HybridGuard::Unlock() {
-  if (mode_ != GuardMode::SHARED && mode_ != GuardMode::EXCLUSIVE) { return; }
+/* Release the lock. An optimistic guard is dropped without validation, e.g. when a restart is already decided */
+template <typename Lock>
+void BasicHybridGuard<Lock>::Unlock() {
+  StopTimer();
   switch (mode_) {
     case GuardMode::SHARED: lock_->UnlockShared(); break;
     case GuardMode::EXCLUSIVE: lock_->UnlockExclusive(); break;
@@ -55,23 +91,102 @@ void HybridGuard::Unlock() {
   mode_ = GuardMode::MOVED;
 }
 
-void HybridGuard::OptimisticLock() {
+template <typename Lock>
+void BasicHybridGuard<Lock>::OptimisticLock() {
   if (mode_ != GuardMode::OPTIMISTIC) { return; }
+  Stats::Add(Counter::OPTIMISTIC_ATTEMPTS);
   state_ = lock_->StateAndVersion().load();
-  while (HybridLock::LockState(state_) == HybridLock::EXCLUSIVE) {
-    std::this_thread::yield();
+  for (Waiter waiter(policy_); Lock::LockState(state_) == Lock::EXCLUSIVE;) {
+    if (waiter.Pause()) { lock_->Park(state_); }
     state_ = lock_->StateAndVersion().load();
   }
 }
 
-void HybridGuard::ValidateOptimisticLock() {
-  if (mode_ != GuardMode::OPTIMISTIC) { return; }
+/**
+ * Optimistic -> exclusive, succeeds only if nobody modified the lock since OptimisticLock().
+ * Throw RestartException otherwise
+ */
+template <typename Lock>
+void BasicHybridGuard<Lock>::UpgradeToExclusive() {
+  if (!TryUpgradeToExclusive()) { throw RestartException(); }
+}
+
+template <typename Lock>
+void BasicHybridGuard<Lock>::ValidateOptimisticLock() {
+  if (!TryValidateOptimisticLock()) { throw RestartException(); }
+}
+
+/**
+ * Same check as ValidateOptimisticLock(), but a successful check keeps the guard in optimistic mode,
+ *  e.g. to make sure a child pointer is valid before dereferencing it while the node is still needed
+ */
+template <typename Lock>
+void BasicHybridGuard<Lock>::CheckOptimisticLock() {
+  if (!TryCheckOptimisticLock()) { throw RestartException(); }
+}
+
+/**
+ * Non-throwing UpgradeToExclusive(). On failure the guard is released (MOVED)
+ */
+template <typename Lock>
+auto BasicHybridGuard<Lock>::TryUpgradeToExclusive() -> bool {
+  if (mode_ != GuardMode::OPTIMISTIC) { return true; }
+  StopTimer();
+  if (!lock_->TryLockExclusive(state_)) {
+    Stats::Add(Counter::VALIDATION_FAILURES);
+    mode_ = GuardMode::MOVED;
+    return false;
+  }
+  Stats::Add(Counter::EXCLUSIVE_ACQUISITIONS);
+  timer_.Start();
+  mode_ = GuardMode::EXCLUSIVE;
+  return true;
+}
+
+/**
+ * Non-throwing ValidateOptimisticLock(). The guard is released (MOVED) whatever the outcome,
+ *  so its destructor will not validate again
+ */
+template <typename Lock>
+auto BasicHybridGuard<Lock>::TryValidateOptimisticLock() -> bool {
+  if (mode_ != GuardMode::OPTIMISTIC) { return true; }
+  StopTimer();
   mode_             = GuardMode::MOVED;
   auto latest_state = lock_->StateAndVersion().load();
-  if (HybridLock::LockState(latest_state) == HybridLock::EXCLUSIVE ||
-      HybridLock::Version(latest_state) != HybridLock::Version(state_)) {
-    throw RestartException();
+  auto valid = Lock::LockState(latest_state) != Lock::EXCLUSIVE && Lock::Version(latest_state) == Lock::Version(state_);
+  if (!valid) { Stats::Add(Counter::VALIDATION_FAILURES); }
+  return valid;
+}
+
+/**
+ * Non-throwing CheckOptimisticLock(). The guard stays optimistic on success, and is released on failure
+ */
+template <typename Lock>
+auto BasicHybridGuard<Lock>::TryCheckOptimisticLock() -> bool {
+  if (mode_ != GuardMode::OPTIMISTIC) { return true; }
+  auto latest_state = lock_->StateAndVersion().load();
+  if (Lock::LockState(latest_state) == Lock::EXCLUSIVE || Lock::Version(latest_state) != Lock::Version(state_)) {
+    Stats::Add(Counter::VALIDATION_FAILURES);
+    StopTimer();
+    mode_ = GuardMode::MOVED;
+    return false;
   }
+  return true;
 }
 
+/* Record the lifetime of the guard in the histogram of its current mode, once it is released */
+template <typename Lock>
+void BasicHybridGuard<Lock>::StopTimer() {
+  if constexpr (!STATS_ENABLED) { return; }
+  switch (mode_) {
+    case GuardMode::OPTIMISTIC: timer_.Stop(Timer::OPTIMISTIC_GUARD); break;
+    case GuardMode::SHARED: timer_.Stop(Timer::SHARED_GUARD); break;
+    case GuardMode::EXCLUSIVE: timer_.Stop(Timer::EXCLUSIVE_GUARD); break;
+    default: break;
+  }
+}
+
+template class BasicHybridGuard<HybridLock>;
+template class BasicHybridGuard<ScalableHybridLock>;
+
 }  // namespace FinalProject
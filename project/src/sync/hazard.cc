@@ -0,0 +1,67 @@
+#include "sync/hazard.h"
+
+#include <algorithm>
+
+namespace FinalProject {
+
+HazardPointerHandler::HazardPointerHandler(uint64_t no_threads) : records_(no_threads) {}
+
+/* Make sure to delete all remaining un-freed pointers */
+HazardPointerHandler::~HazardPointerHandler() {
+  records_.ForEach([](ThreadRecord &record) {
+    for (auto &retired : record.to_free_ptr) { retired.Free(); }
+  });
+}
+
+void HazardPointerHandler::Clear(uint64_t tid) {
+  for (auto &hazard : records_[tid].hazards) { hazard.store(nullptr, std::memory_order_release); }
+}
+
+/**
+ * Retire lists are scanned once they hold twice as many nodes as there are hazard slots in the whole table,
+ *  i.e. 2 * SLOTS_PER_THREAD * Capacity() (512 with the default 128 records), and at least 64.
+ * At most SLOTS_PER_THREAD * Capacity() of them can be protected, so every scan frees at least half of the list
+ */
+auto HazardPointerHandler::ScanThreshold() -> uint64_t {
+  return std::max<uint64_t>(64, 2 * SLOTS_PER_THREAD * Capacity());
+}
+
+/**
+ * Execute the hazard-pointer reclamation
+ *
+ * 1. Snapshot every published hazard pointer
+ * 2. Free all pointers of `ToFreePtr(tid)` which are not in the snapshot
+ */
+void HazardPointerHandler::FreeOutdatedPtr(uint64_t tid) {
+  auto &record = records_[tid];
+  if (record.to_free_ptr.empty()) { return; }
+
+  std::vector<void *> hazards;
+  records_.ForEach([&](ThreadRecord &other) {
+    for (auto &hazard : other.hazards) {
+      auto ptr = hazard.load();
+      if (ptr != nullptr) { hazards.push_back(ptr); }
+    }
+  });
+  std::sort(hazards.begin(), hazards.end());
+
+  auto protected_end = std::partition(record.to_free_ptr.begin(), record.to_free_ptr.end(), [&](const auto &retired) {
+    return std::binary_search(hazards.begin(), hazards.end(), retired.ptr);
+  });
+  for (auto it = protected_end; it != record.to_free_ptr.end(); it++) {
+    it->Free();
+  }
+  record.to_free_ptr.erase(protected_end, record.to_free_ptr.end());
+}
+
+/**
+ * Append the ptr to `ToFreePtr(tid)`, and scan as soon as the list is long enough.
+ * Unlike EpochHandler, this is the only place where memory gets reclaimed, no background thread is needed
+ */
+void HazardPointerHandler::DeferFreePointer(uint64_t tid, void *ptr, uint64_t size, Deleter deleter) {
+  auto &record = records_[tid];
+  record.to_free_ptr.emplace_back(ptr, 0, size, deleter);
+  if (record.to_free_ptr.size() >= ScanThreshold()) { FreeOutdatedPtr(tid); }
+}
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -30,14 +30,40 @@ auto HybridLock::TryLockExclusive(uint64_t old_state_w_version) -> bool {
 /* Unlock exclusive -- must check that the lock is in exclusive mode before unlocking it */
 void HybridLock::UnlockExclusive() {
   assert(IsExclusivelyLocked(StateAndVersion()));
-  state_and_version_.store(NextVersionNewState(state_and_version_.load(), UNLOCKED), std::memory_order_release);
+  ReleaseExclusive(UNLOCKED);
 }
 
 /* Downgrade from exclusive -> shared. */
 void HybridLock::DowngradeLock() {
   assert(IsExclusivelyLocked(StateAndVersion()));
   // 1 here means 1 reader
-  state_and_version_.store(NextVersionNewState(state_and_version_.load(), 1), std::memory_order_release);
+  ReleaseExclusive(1);
+}
+
+/**
+ * Leave the exclusive state with the next version.
+ * While we hold the lock, the only concurrent change to the word is a parker setting PARKED, which the new word
+ *  clears anyway: a single exchange releases the lock, and the futex wake-up is only paid if somebody parked
+ */
+void HybridLock::ReleaseExclusive(uint64_t new_state) {
+  auto old_state_w_version = state_and_version_.load(std::memory_order_relaxed);
+  old_state_w_version      = state_and_version_.exchange(NextVersionNewState(old_state_w_version & ~PARKED, new_state),
+                                                         std::memory_order_release);
+  if ((old_state_w_version & PARKED) != 0) { state_and_version_.notify_all(); }
+}
+
+/**
+ * Sleep until the lock word changes. Only parks if the lock is still held in the observed state,
+ *  the holder clears PARKED and wakes everybody up when it releases the lock
+ */
+void HybridLock::Park(uint64_t old_state_w_version) {
+  if (LockState(old_state_w_version) == UNLOCKED) { return; }
+  auto parked = old_state_w_version | PARKED;
+  if (parked != old_state_w_version &&
+      !state_and_version_.compare_exchange_strong(old_state_w_version, parked)) {
+    return;
+  }
+  state_and_version_.wait(parked);
 }
 
 /* Lock in shared mode. Current lock must not in exclusive mode */
@@ -64,14 +90,18 @@ auto HybridLock::UpgradeLock(uint64_t old_state_w_version) -> bool {
                                                   SameVersionNewState(old_state_w_version, EXCLUSIVE));
 }
 
-/* Unlock shared mode. Decrease the LockState() by 1. Must not be in exclusive lock */
+/* Unlock shared mode. Decrease the LockState() by 1. Must not be in exclusive lock.
+   The last reader wakes up parked writers, readers never park behind other readers */
 void HybridLock::UnlockShared() {
   while (true) {
     auto old_state_w_version = state_and_version_.load();
     auto old_state           = LockState(old_state_w_version);
     assert(IsSharedLocked(old_state_w_version));
-    if (state_and_version_.compare_exchange_weak(old_state_w_version,
-                                                 SameVersionNewState(old_state_w_version, old_state - 1))) {
+    auto last_reader = old_state == 1 && (old_state_w_version & PARKED) != 0;
+    auto new_state_w_version =
+      SameVersionNewState(last_reader ? old_state_w_version & ~PARKED : old_state_w_version, old_state - 1);
+    if (state_and_version_.compare_exchange_weak(old_state_w_version, new_state_w_version)) {
+      if (last_reader) { state_and_version_.notify_all(); }
       break;
     }
   }
@@ -0,0 +1,86 @@
+#include "sync/scalable_lock.h"
+#include "sync/wait.h"
+
+#include <cassert>
+#include <thread>
+
+namespace FinalProject {
+
+std::atomic<uint64_t> next_reader_slot = 0;
+
+/* Slot of the calling thread, handed out round-robin on first use */
+auto ScalableHybridLock::Slot() -> uint64_t {
+  thread_local uint64_t slot = next_reader_slot.fetch_add(1) % READER_SLOTS;
+  return slot;
+}
+
+/* Number of shared-lock holders, summed over all slots */
+auto ScalableHybridLock::Readers() -> uint64_t {
+  uint64_t readers = 0;
+  for (auto &slot : readers_) { readers += slot.count.load(); }
+  return readers;
+}
+
+/* Wait until at most `remaining` shared holders are left. The exclusive state keeps new ones out.
+   The slots are not a futex word, so the last resort is yielding instead of parking */
+void ScalableHybridLock::WaitForReaders(uint64_t remaining) {
+  Waiter waiter(WaitPolicy::Default());
+  while (Readers() > remaining) {
+    if (waiter.Pause()) { std::this_thread::yield(); }
+  }
+}
+
+/**
+ * Announce the exclusive lock first, then wait for the readers which got in before.
+ * Return false only if somebody else holds the lock exclusively or the state changed
+ */
+auto ScalableHybridLock::TryLockExclusive(uint64_t old_state_w_version) -> bool {
+  if (LockState(old_state_w_version) != UNLOCKED) { return false; }
+  if (!state_and_version_.compare_exchange_strong(old_state_w_version,
+                                                  SameVersionNewState(old_state_w_version, EXCLUSIVE))) {
+    return false;
+  }
+  WaitForReaders(0);
+  return true;
+}
+
+/**
+ * Increment the own slot, then re-check the state: either the writer sees our slot,
+ *  or we see its exclusive state and back off (both sides use seq_cst)
+ */
+auto ScalableHybridLock::TryLockShared(uint64_t old_state_w_version) -> bool {
+  if (LockState(old_state_w_version) == EXCLUSIVE) { return false; }
+  auto &slot = readers_[Slot()].count;
+  slot.fetch_add(1);
+  if (LockState(state_and_version_.load()) == EXCLUSIVE) {
+    slot.fetch_sub(1);
+    return false;
+  }
+  return true;
+}
+
+void ScalableHybridLock::UnlockShared() {
+  assert(readers_[Slot()].count.load() > 0);
+  readers_[Slot()].count.fetch_sub(1, std::memory_order_release);
+}
+
+/* Upgrade from shared -> exclusive. Unlike HybridLock, waits for the other readers instead of failing */
+auto ScalableHybridLock::UpgradeLock(uint64_t old_state_w_version) -> bool {
+  if (LockState(old_state_w_version) != UNLOCKED) { return false; }
+  if (!state_and_version_.compare_exchange_strong(old_state_w_version,
+                                                  SameVersionNewState(old_state_w_version, EXCLUSIVE))) {
+    return false;
+  }
+  WaitForReaders(1);
+  readers_[Slot()].count.fetch_sub(1);
+  return true;
+}
+
+/* Downgrade from exclusive -> shared. */
+void ScalableHybridLock::DowngradeLock() {
+  assert(IsExclusivelyLocked(StateAndVersion()));
+  readers_[Slot()].count.fetch_add(1);
+  ReleaseExclusive(UNLOCKED);
+}
+
+}  // namespace FinalProject
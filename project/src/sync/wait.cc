@@ -0,0 +1,80 @@
+#include "sync/wait.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace FinalProject {
+
+/* ~64 short spins cover the common short critical section, the backoff reaches ~1000 pauses after 10 steps */
+auto WaitPolicy::Default() -> const WaitPolicy & {
+  static const WaitPolicy policy{64, 10, 1024, true};
+  return policy;
+}
+
+void CpuPause() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+/**
+ * Wait a bit before the next acquisition attempt.
+ * Return true once spinning and backoff are exhausted: the caller should park on the lock word now
+ */
+auto Waiter::Pause() -> bool {
+  if constexpr (STATS_ENABLED) {
+    Stats::Add(Counter::SPIN_ITERATIONS);
+    if (wait_start_ == 0) { wait_start_ = NowNs(); }
+  }
+  if (attempt_ < policy_.spin_iterations) {
+    attempt_++;
+    CpuPause();
+    return false;
+  }
+  if (attempt_ < policy_.spin_iterations + policy_.backoff_iterations) {
+    attempt_++;
+    for (auto idx = 0U; idx < backoff_; idx++) { CpuPause(); }
+    backoff_ = std::min(backoff_ * 2, policy_.max_backoff_pauses);
+    return false;
+  }
+  if (!policy_.park) {
+    std::this_thread::yield();
+    return false;
+  }
+  return true;
+}
+
+/* Time between the first Pause() and the successful acquisition, including the time parked */
+void Waiter::RecordWait() { Stats::Add(Counter::WAIT_NS, NowNs() - wait_start_); }
+
+/**
+ * Optimistic attempts left to the next operation: the full budget while restarts are rare,
+ *  down to a single attempt once operations restart more than `max_optimistic_attempts` times on average
+ */
+auto RestartTracker::Budget() const -> uint32_t {
+  if (!policy_.adaptive) { return policy_.max_optimistic_attempts; }
+  auto rate = rate_.load(std::memory_order_relaxed);
+  return std::max<uint32_t>(1, policy_.max_optimistic_attempts / (1 + (rate >> 8)));
+}
+
+/**
+ * Fold the restarts of one finished operation into the moving average (weight 1/8).
+ * Restart-free operations are sampled: while the rate is zero they write nothing,
+ *  otherwise every SAMPLE_PERIOD of them on this tracker halve the rate
+ */
+void RestartTracker::Record(uint32_t restarts) {
+  if (!policy_.adaptive) { return; }
+  auto rate = rate_.load(std::memory_order_relaxed);
+  if (restarts == 0) {
+    if (rate == 0 || skipped_.fetch_add(1, std::memory_order_relaxed) + 1 < SAMPLE_PERIOD) { return; }
+    skipped_.store(0, std::memory_order_relaxed);
+    rate_.store(rate >> 1, std::memory_order_relaxed);
+    return;
+  }
+  auto sample = std::min<uint32_t>(restarts, 1U << 16) << 8;
+  rate_.store(rate - (rate >> 3) + (sample >> 3), std::memory_order_relaxed);
+}
+
+}  // namespace FinalProject
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "tree/btree.h"
+#include <algorithm>
+#include <cstdlib>
+#include "common/utils.h"
+#include "sync/epoch.h"
+#include "sync/guard.h"
+
+namespace FinalProject {
+
+template <typename T, uint64_t NODE_SIZE>
+OptimisticBTree<T, NODE_SIZE>::OptimisticBTree(EpochHandler *ep) : root_(NewLeaf()), epoch_(ep) {}
+
+template <typename T, uint64_t NODE_SIZE>
+OptimisticBTree<T, NODE_SIZE>::~OptimisticBTree() { FreeSubtree(root_); }
+
+template <typename T, uint64_t NODE_SIZE>
+void OptimisticBTree<T, NODE_SIZE>::FreeSubtree(BTreeNode *node) {
+  if (!node->is_leaf) {
+    auto inner = static_cast<Inner *>(node);
+    for (auto idx = 0; idx <= inner->count; idx++) { FreeSubtree(inner->children[idx]); }
+  }
+  FreeNode(node, 0);
+}
+
+/* Deleter of retired leaves, also runs the destructors of the values and separators the node holds */
+template <typename T, uint64_t NODE_SIZE>
+void OptimisticBTree<T, NODE_SIZE>::FreeNode(void *ptr, uint64_t) {
+  auto node = static_cast<BTreeNode *>(ptr);
+  if (node->is_leaf) {
+    static_cast<Leaf *>(node)->~Leaf();
+  } else {
+    static_cast<Inner *>(node)->~Inner();
+  }
+  free(node);
+}
+
+template <typename T, uint64_t NODE_SIZE>
+auto OptimisticBTree<T, NODE_SIZE>::NewLeaf() -> Leaf * {
+  auto memory = malloc(sizeof(Leaf));
+  return new (memory) Leaf();
+}
+
+template <typename T, uint64_t NODE_SIZE>
+auto OptimisticBTree<T, NODE_SIZE>::NewInner() -> Inner * {
+  auto memory = malloc(sizeof(Inner));
+  return new (memory) Inner();
+}
+
+/**
+ * Split `child` in two halves and register the right half in `parent`.
+ * `parent == nullptr` means `child` is the root, and a new root is installed.
+ * Caller must hold both `child` and `parent` (root_lock_ for the root) exclusively
+ */
+template <typename T, uint64_t NODE_SIZE>
+void OptimisticBTree<T, NODE_SIZE>::SplitChild(Inner *parent, BTreeNode *child) {
+  T separator;
+  BTreeNode *right;
+  if (child->is_leaf) {
+    auto leaf     = static_cast<Leaf *>(child);
+    auto new_leaf = NewLeaf();
+    uint16_t mid  = leaf->count / 2;
+    std::copy(leaf->values + mid, leaf->values + leaf->count, new_leaf->values);
+    new_leaf->count = leaf->count - mid;
+    leaf->count     = mid;
+    separator       = leaf->values[mid - 1];
+    right           = new_leaf;
+  } else {
+    auto inner     = static_cast<Inner *>(child);
+    auto new_inner = NewInner();
+    uint16_t mid   = inner->count / 2;
+    std::copy(inner->keys + mid + 1, inner->keys + inner->count, new_inner->keys);
+    std::copy(inner->children + mid + 1, inner->children + inner->count + 1, new_inner->children);
+    new_inner->count = inner->count - mid - 1;
+    inner->count     = mid;
+    separator        = inner->keys[mid];
+    right            = new_inner;
+  }
+
+  if (parent == nullptr) {
+    auto new_root         = NewInner();
+    new_root->count       = 1;
+    new_root->keys[0]     = separator;
+    new_root->children[0] = child;
+    new_root->children[1] = right;
+    root_                 = new_root;
+    return;
+  }
+  auto pos = KeyLowerBound(parent->keys, parent->count, separator);
+  std::copy_backward(parent->keys + pos, parent->keys + parent->count, parent->keys + parent->count + 1);
+  std::copy_backward(parent->children + pos + 1, parent->children + parent->count + 1,
+                     parent->children + parent->count + 2);
+  parent->keys[pos]         = separator;
+  parent->children[pos + 1] = right;
+  parent->count++;
+}
+
+/**
+ * All three operations share the same descent:
+ * - read the child pointer, then check the current node before dereferencing the pointer
+ * - read the child's version, and only then validate the parent (via the guard move),
+ *    so that the child's version was taken while it was still linked
+ */
+template <typename T, uint64_t NODE_SIZE>
+void OptimisticBTree<T, NODE_SIZE>::Insert(T value) {
+  while (true) {
+    try {
+      EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+      HybridGuard parent_guard(&root_lock_, GuardMode::OPTIMISTIC);
+      Inner *parent = nullptr;
+      auto node     = root_;
+      parent_guard.CheckOptimisticLock();
+      HybridGuard node_guard(&node->lock, GuardMode::OPTIMISTIC);
+
+      while (!node->is_leaf) {
+        auto inner = static_cast<Inner *>(node);
+        if (inner->IsFull()) {
+          // Eager split, so the parent of any node we split later has room for the separator
+          parent_guard.UpgradeToExclusive();
+          node_guard.UpgradeToExclusive();
+          SplitChild(parent, inner);
+          throw RestartException();
+        }
+        auto child = inner->children[KeyLowerBound(inner->keys, inner->count, value)];
+        node_guard.CheckOptimisticLock();
+        HybridGuard child_guard(&child->lock, GuardMode::OPTIMISTIC);
+        parent_guard = std::move(node_guard);
+        node_guard   = std::move(child_guard);
+        parent       = inner;
+        node         = child;
+      }
+
+      auto leaf = static_cast<Leaf *>(node);
+      if (leaf->IsFull()) {
+        parent_guard.UpgradeToExclusive();
+        node_guard.UpgradeToExclusive();
+        SplitChild(parent, leaf);
+        throw RestartException();
+      }
+      node_guard.UpgradeToExclusive();
+      parent_guard.ValidateOptimisticLock();
+      auto pos = KeyLowerBound(leaf->values, leaf->count, value);
+      if (pos < leaf->count && leaf->values[pos] <=> value == 0) {
+        leaf->values[pos] = value;
+        return;
+      }
+      std::copy_backward(leaf->values + pos, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+      leaf->values[pos] = value;
+      leaf->count++;
+      return;
+    } catch (const RestartException &) {}
+  }
+}
+
+/* Exception-free version of the descent, a failed check drops the guards and restarts from the root */
+template <typename T, uint64_t NODE_SIZE>
+auto OptimisticBTree<T, NODE_SIZE>::LookUp(T value, T &result) -> bool {
+  while (true) {
+    EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+    HybridGuard parent_guard(&root_lock_, GuardMode::OPTIMISTIC);
+    auto node = root_;
+    if (!parent_guard.TryCheckOptimisticLock()) { continue; }
+    HybridGuard node_guard(&node->lock, GuardMode::OPTIMISTIC);
+
+    auto valid = true;
+    while (valid && !node->is_leaf) {
+      auto inner = static_cast<Inner *>(node);
+      auto child = inner->children[KeyLowerBound(inner->keys, inner->count, value)];
+      if (!node_guard.TryCheckOptimisticLock()) {
+        valid = false;
+        break;
+      }
+      HybridGuard child_guard(&child->lock, GuardMode::OPTIMISTIC);
+      valid = parent_guard.TryValidateOptimisticLock();
+      parent_guard = std::move(node_guard);
+      node_guard   = std::move(child_guard);
+      node         = child;
+    }
+    if (!valid || !parent_guard.TryValidateOptimisticLock()) {
+      parent_guard.Unlock();
+      node_guard.Unlock();
+      continue;
+    }
+
+    auto leaf  = static_cast<Leaf *>(node);
+    auto pos   = KeyLowerBound(leaf->values, leaf->count, value);
+    auto found = pos < leaf->count && leaf->values[pos] <=> value == 0;
+    if (found) { result = leaf->values[pos]; }
+    if (node_guard.TryValidateOptimisticLock()) { return found; }
+  }
+}
+
+template <typename T, uint64_t NODE_SIZE>
+auto OptimisticBTree<T, NODE_SIZE>::Delete(T value) -> bool {
+  while (true) {
+    try {
+      EpochGuard epoch_guard(&epoch_->LocalEpoch(thread_id), epoch_->global_epoch);
+      HybridGuard parent_guard(&root_lock_, GuardMode::OPTIMISTIC);
+      Inner *parent = nullptr;
+      auto node     = root_;
+      parent_guard.CheckOptimisticLock();
+      HybridGuard node_guard(&node->lock, GuardMode::OPTIMISTIC);
+
+      while (!node->is_leaf) {
+        auto inner = static_cast<Inner *>(node);
+        auto child = inner->children[KeyLowerBound(inner->keys, inner->count, value)];
+        node_guard.CheckOptimisticLock();
+        HybridGuard child_guard(&child->lock, GuardMode::OPTIMISTIC);
+        parent_guard = std::move(node_guard);
+        node_guard   = std::move(child_guard);
+        parent       = inner;
+        node         = child;
+      }
+
+      auto leaf = static_cast<Leaf *>(node);
+      auto pos  = KeyLowerBound(leaf->values, leaf->count, value);
+      if (pos == leaf->count || leaf->values[pos] <=> value != 0) {
+        parent_guard.ValidateOptimisticLock();
+        return false;
+      }
+
+      if (leaf->count == 1 && parent != nullptr && parent->count > 0) {
+        // The leaf becomes empty: unlink it, its neighbour takes over its key range
+        parent_guard.UpgradeToExclusive();
+        node_guard.UpgradeToExclusive();
+        uint16_t idx = 0;
+        while (parent->children[idx] != leaf) { idx++; }
+        uint16_t key_idx = (idx < parent->count) ? idx : idx - 1;
+        std::copy(parent->keys + key_idx + 1, parent->keys + parent->count, parent->keys + key_idx);
+        std::copy(parent->children + idx + 1, parent->children + parent->count + 1, parent->children + idx);
+        parent->count--;
+        epoch_->DeferFreePointer(thread_id, leaf, sizeof(Leaf), FreeNode);
+        return true;
+      }
+      node_guard.UpgradeToExclusive();
+      parent_guard.ValidateOptimisticLock();
+      std::copy(leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos);
+      leaf->count--;
+      return true;
+    } catch (const RestartException &) {}
+  }
+}
+
+}  // namespace FinalProject
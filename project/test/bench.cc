@@ -0,0 +1,679 @@
+#include "common/histogram.h"
+#include "common/perf_event.h"
+#include "common/simd.h"
+#include "common/stats.h"
+#include "common/utils.h"
+#include "list/list.h"
+#include "list/lock_free_list.h"
+#include "list/skip_list.h"
+#include "list/unrolled_list.h"
+#include "list/workload.h"
+#include "sync/guard.h"
+#include "sync/hazard.h"
+#include "sync/scalable_lock.h"
+#include "sync/wait.h"
+#include "tree/btree.h"
+#include "../src/list/list.cc"
+#include "../src/list/lock_free_list.cc"
+#include "../src/list/skip_list.cc"
+#include "../src/list/unrolled_list.cc"
+#include "../src/tree/btree.cc"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace FinalProject;
+
+/**
+ * Workload driver: loads every list variant, runs the configured mix for a fixed duration
+ *  and reports throughput and hardware counters per operation (see list/workload.h).
+ * A preset is applied first, the other options override it.
+ * --micro[=NAME] runs the micro-benchmarks whose name contains NAME instead, see MICRO_BENCHMARKS
+ */
+static constexpr const char *USAGE =
+  "[--workload=a|b|c|d|e] [--lookup=W] [--insert=W] [--delete=W] [--scan=W] [--scan-length=N]\n"
+  "  [--distribution=uniform|zipfian|latest] [--theta=T] [--keys=N] [--threads=N] [--duration=MS] [--list=NAME]\n"
+  "  [--latency] [--micro[=NAME]]";
+
+struct BenchConfig {
+  WorkloadConfig workload;
+  std::string list;                  // Only run the variants whose name contains this string
+  std::optional<std::string> micro;  // Run the micro-benchmarks whose name contains this string instead
+};
+
+auto ParseDistribution(const std::string &name) -> KeyDistribution {
+  if (name == "uniform") { return KeyDistribution::UNIFORM; }
+  if (name == "zipfian") { return KeyDistribution::ZIPFIAN; }
+  if (name == "latest") { return KeyDistribution::LATEST; }
+  throw std::invalid_argument("Unknown key distribution");
+}
+
+auto ParseArguments(int argc, char **argv) -> BenchConfig {
+  BenchConfig config;
+  auto &workload   = config.workload;
+  workload.threads = std::max(1U, std::thread::hardware_concurrency());
+  try {
+    for (auto idx = 1; idx < argc; idx++) {
+      std::string arg(argv[idx]);
+      auto pos   = arg.find('=');
+      auto key   = arg.substr(0, pos);
+      auto value = (pos == std::string::npos) ? std::string() : arg.substr(pos + 1);
+      if (key == "--workload" && value.size() == 1) {
+        auto preset        = WorkloadConfig::Preset(value[0]);
+        preset.keys        = workload.keys;
+        preset.threads     = workload.threads;
+        preset.duration_ms = workload.duration_ms;
+        workload           = preset;
+      } else if (key == "--lookup") {
+        workload.lookups = std::stoul(value);
+      } else if (key == "--insert") {
+        workload.inserts = std::stoul(value);
+      } else if (key == "--delete") {
+        workload.deletes = std::stoul(value);
+      } else if (key == "--scan") {
+        workload.scans = std::stoul(value);
+      } else if (key == "--scan-length") {
+        workload.scan_length = std::stoul(value);
+      } else if (key == "--distribution") {
+        workload.distribution = ParseDistribution(value);
+      } else if (key == "--theta") {
+        workload.zipf_theta = std::min(std::stod(value), 0.999);
+      } else if (key == "--keys") {
+        workload.keys = std::max(1UL, std::stoul(value));
+      } else if (key == "--threads") {
+        workload.threads = std::max(1, std::stoi(value));
+      } else if (key == "--duration") {
+        workload.duration_ms = std::stoul(value);
+      } else if (key == "--latency") {
+        workload.record_latency = true;
+      } else if (key == "--list") {
+        config.list = value;
+      } else if (key == "--micro") {
+        config.micro = value;
+      } else {
+        throw std::invalid_argument(arg);
+      }
+    }
+  } catch (const std::exception &error) {
+    std::cerr << "Invalid option (" << error.what() << ")\nUsage: " << argv[0] << " " << USAGE << std::endl;
+    std::exit(1);
+  }
+  return config;
+}
+
+void PrintLatency(const char *label, const LatencyHistogram &histogram) {
+  if (histogram.Count() == 0) { return; }
+  std::cout << "  " << std::left << std::setw(26) << label << std::right;
+  histogram.Print(std::cout);
+  std::cout << std::endl;
+}
+
+void Run(const char *name, SortedList<uint64_t> &list, const BenchConfig &config) {
+  if (!config.list.empty() && std::string(name).find(config.list) == std::string::npos) { return; }
+  std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2);
+
+  LoadWorkload(list, config.workload);
+  WorkloadResult result;
+  try {
+    result = RunWorkload(list, config.workload);
+  } catch (const std::logic_error &error) {
+    std::cout << "skipped: " << error.what() << std::endl;
+    return;
+  }
+
+  auto ops = std::max<uint64_t>(result.TotalOps(), 1);
+  std::cout << std::setw(10) << ops / result.seconds / 1e6 << " Mops/s";
+  for (auto event : {PerfEvent::CYCLES, PerfEvent::INSTRUCTIONS, PerfEvent::CACHE_MISSES}) {
+    std::cout << std::setw(10) << result.counters[event] / ops << " " << PerfEvent::Name(event) << "/op";
+  }
+  if constexpr (STATS_ENABLED) {
+    std::cout << std::setw(10) << static_cast<double>(result.stats[Counter::VALIDATION_FAILURES]) / ops
+              << " restarts/op";
+  }
+  std::cout << std::endl;
+
+  // Tail latencies in ns, per operation type and, with ENABLE_STATS, per guard mode
+  if (config.workload.record_latency) {
+    for (auto idx = 0U; idx < result.latencies.size(); idx++) {
+      PrintLatency(WorkloadResult::Name(static_cast<WorkloadOp>(idx)), result.latencies[idx]);
+    }
+  }
+  if constexpr (STATS_ENABLED) {
+    for (auto timer : {Timer::OPTIMISTIC_GUARD, Timer::SHARED_GUARD, Timer::EXCLUSIVE_GUARD}) {
+      PrintLatency(StatsSnapshot::Name(timer), result.stats[timer]);
+    }
+  }
+}
+
+/* ---------------------------------------- Micro-benchmarks ---------------------------------------- */
+
+auto Generate(unsigned n) -> std::vector<unsigned> {
+  std::vector<unsigned> data(n);
+  std::iota(data.begin(), data.end(), 0);
+  std::shuffle(data.begin(), data.end(), std::mt19937(42));
+  return data;
+}
+
+/* Fat value ordered by a small key, the case the split node layout is meant for */
+struct Student {
+  unsigned id{0};
+  std::string name;
+  uint8_t semester{0};
+
+  auto operator<=>(const Student &other) const { return id <=> other.id; }
+  auto operator==(const Student &other) const -> bool { return id == other.id; }
+};
+
+struct StudentId {
+  auto operator()(const Student &student) const -> unsigned { return student.id; }
+};
+
+auto MakeStudent(unsigned id) -> Student {
+  return {id, "student with a name longer than the small string buffer " + std::to_string(id), 1};
+}
+
+/* Run `work(tid)` on `threads` registered worker threads and wait for all of them */
+template <typename Fn>
+void RunThreads(uint32_t threads, Fn &&work) {
+  std::vector<std::thread> workers;
+  for (auto idx = 0U; idx < threads; idx++) {
+    workers.emplace_back([&, tid = idx]() {
+      InitializeThread();
+      work(tid);
+    });
+  }
+  for (auto &worker : workers) { worker.join(); }
+}
+
+/**
+ * Shared driver of every micro-benchmark: run `body` under the hardware counters,
+ *  and report its `ops` operations as throughput, time and cache misses per operation.
+ * Returns the elapsed seconds
+ */
+template <typename Fn>
+auto Measure(const char *name, uint64_t ops, Fn &&body) -> double {
+  PerfEvent perf;
+  perf.StartCounters();
+  body();
+  perf.StopCounters();
+  ops = std::max<uint64_t>(ops, 1);
+  std::cout << "  " << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(10) << ops / perf.Seconds() / 1e6 << " Mops/s" << std::setw(10)
+            << perf.Seconds() * 1e9 / ops << " ns/op" << std::setw(10)
+            << perf.Value(PerfEvent::CACHE_MISSES) / ops << " cache-misses/op" << std::endl;
+  return perf.Seconds();
+}
+
+/* Insert/delete churn on a per-thread key range, so the node allocator is the only shared resource left */
+template <typename Alloc>
+void RunAllocatorBenchmark(const char *name, uint32_t threads) {
+  static constexpr unsigned NO_KEYS   = 1000;
+  static constexpr unsigned NO_ROUNDS = 200;
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  epoch.StartReclaimer();
+  LockFreeSortedList<unsigned, Alloc> list(&epoch);
+  Measure(name, 2 * NO_ROUNDS * NO_KEYS, [&]() {
+    RunThreads(threads, [&](uint32_t tid) {
+      for (auto round = 0U; round < NO_ROUNDS; round++) {
+        for (auto key = tid; key < NO_KEYS; key += threads) { list.Insert(key); }
+        for (auto key = tid; key < NO_KEYS; key += threads) { list.Delete(key); }
+      }
+    });
+  });
+}
+
+void BenchAllocator(uint32_t threads) {
+  RunAllocatorBenchmark<MallocAllocator>("MallocAllocator", threads);
+  RunAllocatorBenchmark<PoolAllocator>("PoolAllocator", threads);
+}
+
+/* Point lookups vs one LookUpBatch over the same sorted probe set */
+void BenchLookUpBatch(uint32_t) {
+  static constexpr unsigned NO_KEYS = 10000;
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned> list(&epoch);
+  for (unsigned key = 0; key < NO_KEYS; key++) { list.Insert(key); }
+
+  std::vector<unsigned> keys;
+  for (unsigned key = 0; key < NO_KEYS; key += 10) { keys.push_back(key); }
+  std::vector<unsigned> results(keys.size());
+  std::unique_ptr<bool[]> found(new bool[keys.size()]);
+  Measure("LookUp", keys.size(), [&]() {
+    for (auto idx = 0U; idx < keys.size(); idx++) { found[idx] = list.LookUp(keys[idx], results[idx]); }
+  });
+  Measure("LookUpBatch", keys.size(), [&]() { list.LookUpBatch(keys, results, {found.get(), keys.size()}); });
+}
+
+/* Readers probe while a writer loads and expires NO_KEYS keys, once key by key and once in batches */
+template <bool BATCH>
+void RunIngestBenchmark(const char *name, uint32_t threads) {
+  static constexpr unsigned NO_KEYS    = 20000;
+  static constexpr unsigned BATCH_SIZE = 1000;
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned> list(&epoch);
+  std::atomic<bool> done        = false;
+  std::atomic<uint64_t> lookups = 0;
+
+  std::thread readers([&]() {
+    RunThreads(std::max(threads, 2U) - 1, [&](uint32_t) {
+      unsigned result;
+      for (unsigned key = 0; !done.load(); key = (key + 7919) % NO_KEYS) {
+        list.LookUp(key, result);
+        lookups++;
+      }
+    });
+  });
+  auto seconds = Measure(name, 2 * NO_KEYS, [&]() {
+    std::vector<unsigned> batch(BATCH_SIZE);
+    for (unsigned key = 0; key < NO_KEYS; key += BATCH_SIZE) {
+      std::iota(batch.begin(), batch.end(), key);
+      if constexpr (BATCH) {
+        list.InsertBatch(batch);
+      } else {
+        for (auto value : batch) { list.Insert(value); }
+      }
+    }
+    for (unsigned key = 0; key < NO_KEYS; key += BATCH_SIZE) {
+      std::iota(batch.begin(), batch.end(), key);
+      if constexpr (BATCH) {
+        list.DeleteBatch(batch);
+      } else {
+        for (auto value : batch) { list.Delete(value); }
+      }
+    }
+  });
+  done = true;
+  readers.join();
+  std::cout << "    " << lookups.load() / seconds / 1e6 << " M concurrent lookups/s" << std::endl;
+}
+
+void BenchIngest(uint32_t threads) {
+  RunIngestBenchmark<false>("Insert/Delete", threads);
+  RunIngestBenchmark<true>("InsertBatch/DeleteBatch", threads);
+}
+
+/* LookUp latency while writers keep bumping the version, with and without a restart budget */
+void RunRestartPolicyBenchmark(const char *name, const RestartPolicy &policy, uint32_t threads) {
+  static constexpr unsigned NO_KEYS    = 2000;
+  static constexpr unsigned NO_LOOKUPS = 2000;
+  auto no_writers = std::max(threads / 2, 1U);
+  auto no_readers = std::max(threads - no_writers, 1U);
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned> list(&epoch, policy);
+  for (unsigned key = 0; key < NO_KEYS; key += 2) { list.Insert(key); }
+
+  std::atomic<bool> done = false;
+  std::thread writers([&]() {
+    RunThreads(no_writers, [&](uint32_t tid) {
+      for (auto key = 2 * tid + 1; !done.load(); key = (key + 2 * no_writers) % NO_KEYS) {
+        list.Insert(key);
+        list.Delete(key);
+      }
+    });
+  });
+  std::vector<LatencyHistogram> latencies(no_readers);
+  Measure(name, no_readers * NO_LOOKUPS, [&]() {
+    RunThreads(no_readers, [&](uint32_t tid) {
+      unsigned result;
+      for (auto op = 0U; op < NO_LOOKUPS; op++) {
+        auto before = NowNs();
+        list.LookUp(NO_KEYS - 2, result);
+        latencies[tid].Record(NowNs() - before);
+      }
+    });
+  });
+  done = true;
+  writers.join();
+  for (auto idx = 1U; idx < no_readers; idx++) { latencies[0].Merge(latencies[idx]); }
+  PrintLatency("  LookUp ns", latencies[0]);
+}
+
+void BenchRestartPolicy(uint32_t threads) {
+  RunRestartPolicyBenchmark("unbounded restarts", RestartPolicy::Unbounded(), threads);
+  RunRestartPolicyBenchmark("adaptive budget", RestartPolicy::Default(), threads);
+}
+
+/* NO_PROBES lookups in a list loaded with `no_keys` shuffled keys, `make` turns a key into a value of the list */
+template <typename List, typename Make>
+void RunProbeBenchmark(const char *name, unsigned no_keys, Make &&make) {
+  static constexpr unsigned NO_PROBES = 2000;
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  List list(&epoch);
+  for (auto key : Generate(no_keys)) { list.Insert(make(key)); }
+  std::vector<decltype(make(0U))> probes;
+  for (unsigned idx = 0; idx < NO_PROBES; idx++) { probes.push_back(make(idx * 7919 % no_keys)); }
+
+  decltype(make(0U)) result;
+  Measure(name, NO_PROBES, [&]() {
+    for (const auto &probe : probes) { list.LookUp(probe, result); }
+  });
+}
+
+/* Lookups over fat values: the inline layout drags every node's value through the cache, the split one does not */
+void BenchSplitLayout(uint32_t) {
+  // Pooled nodes in both cases, so that the split nodes are packed instead of interleaved with their payloads
+  RunProbeBenchmark<OptimisticSortedList<Student, PoolAllocator>>("inline layout", 10000, MakeStudent);
+  RunProbeBenchmark<OptimisticSortedList<Student, PoolAllocator, EpochHandler, SplitKey<Student, StudentId>>>(
+    "split layout", 10000, MakeStudent);
+}
+
+/* Lookups over a long list: one node per value vs binary search in 512 byte chunks */
+void BenchUnrolled(uint32_t) {
+  auto identity = [](unsigned key) { return key; };
+  RunProbeBenchmark<OptimisticSortedList<unsigned>>("OptimisticSortedList", 20000, identity);
+  RunProbeBenchmark<UnrolledSortedList<unsigned>>("UnrolledSortedList", 20000, identity);
+}
+
+/**
+ * LookUp cost per visited node with and without jump pointers, at sizes around and beyond the L2 cache.
+ * The list is loaded in shuffled batches, so that neighbours in the list are not neighbours in memory
+ */
+template <typename KeyTrait>
+void RunPrefetchBenchmark(const char *name, unsigned no_keys) {
+  static constexpr unsigned NO_BATCHES = 16;
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned, MallocAllocator, EpochHandler, KeyTrait> list(&epoch);
+  auto keys = Generate(no_keys);
+  for (unsigned batch = 0; batch < NO_BATCHES; batch++) {
+    auto begin = keys.begin() + batch * no_keys / NO_BATCHES;
+    auto end   = keys.begin() + (batch + 1) * no_keys / NO_BATCHES;
+    list.InsertBatch(std::vector<unsigned>(begin, end));
+  }
+
+  // One operation is one visited node
+  auto no_probes   = std::max(4U, (1U << 22) / no_keys);
+  uint64_t visited = 0;
+  for (unsigned idx = 0; idx < no_probes; idx++) { visited += keys[idx % no_keys] + 1; }
+  auto label = std::string(name) + ", " + std::to_string(no_keys) + " keys (" +
+               std::to_string(no_keys * sizeof(typename KeyTrait::Node) / 1024) + " KiB)";
+  unsigned result;
+  Measure(label.c_str(), visited, [&]() {
+    for (unsigned idx = 0; idx < no_probes; idx++) { list.LookUp(keys[idx % no_keys], result); }
+  });
+}
+
+void BenchPrefetch(uint32_t) {
+  for (unsigned no_keys : {1U << 12, 1U << 16, 1U << 20}) {
+    RunPrefetchBenchmark<InlineKey<unsigned>>("no prefetch", no_keys);
+    RunPrefetchBenchmark<JumpKey<unsigned, 8>>("jump pointers", no_keys);
+  }
+}
+
+/* Shared acquire/release throughput, every thread hammers the same lock */
+template <typename Lock>
+void RunSharedBenchmark(const char *name, uint32_t threads) {
+  static constexpr unsigned NO_ACQUIRES = 1000000;
+  Lock lock;
+  Measure(name, threads * NO_ACQUIRES, [&]() {
+    RunThreads(threads, [&](uint32_t) {
+      for (auto op = 0U; op < NO_ACQUIRES; op++) { BasicHybridGuard<Lock> guard(&lock, GuardMode::SHARED); }
+    });
+  });
+}
+
+void BenchLockShared(uint32_t threads) {
+  RunSharedBenchmark<HybridLock>("HybridLock", threads);
+  RunSharedBenchmark<ScalableHybridLock>("ScalableHybridLock", threads);
+}
+
+/* Oversubscribed exclusive contention (four workers per thread), reports the tail of the acquisition latency */
+void RunContentionBenchmark(const char *name, const WaitPolicy &policy, uint32_t threads) {
+  static constexpr unsigned NO_SECTIONS = 200;
+  auto no_workers  = 4 * threads;
+  HybridLock lock;
+  uint64_t counter = 0;
+  std::vector<LatencyHistogram> latencies(no_workers);
+  Measure(name, no_workers * NO_SECTIONS, [&]() {
+    RunThreads(no_workers, [&](uint32_t tid) {
+      for (auto op = 0U; op < NO_SECTIONS; op++) {
+        auto before = NowNs();
+        HybridGuard guard(&lock, GuardMode::EXCLUSIVE, policy);
+        latencies[tid].Record(NowNs() - before);
+        for (auto spin = 0; spin < 1000; spin++) { counter = counter + 1; }
+      }
+    });
+  });
+  for (auto idx = 1U; idx < no_workers; idx++) { latencies[0].Merge(latencies[idx]); }
+  PrintLatency("  acquisition ns", latencies[0]);
+}
+
+void BenchLockContention(uint32_t threads) {
+  RunContentionBenchmark("yield only", WaitPolicy{0, 0, 1, false}, threads);
+  RunContentionBenchmark("spin, backoff, park", WaitPolicy::Default(), threads);
+}
+
+/**
+ * Cost of one failed optimistic validation, every reader restarts once per round.
+ * Each thread bumps the version of its own lock, so only the restart mechanism itself is shared
+ */
+template <bool THROWING>
+void RunRestartBenchmark(const char *name, uint32_t no_readers) {
+  static constexpr unsigned NO_RESTARTS = 100000;
+  auto label = std::string(name) + " x" + std::to_string(no_readers);
+  Measure(label.c_str(), no_readers * NO_RESTARTS, [&]() {
+    RunThreads(no_readers, [&](uint32_t) {
+      HybridLock lock;
+      for (auto op = 0U; op < NO_RESTARTS; op++) {
+        HybridGuard guard(&lock, GuardMode::OPTIMISTIC);
+        lock.TryLockExclusive(lock.StateAndVersion().load());
+        lock.UnlockExclusive();
+        if constexpr (THROWING) {
+          try {
+            guard.ValidateOptimisticLock();
+          } catch (const RestartException &) {}
+        } else {
+          guard.TryValidateOptimisticLock();
+        }
+      }
+    });
+  });
+}
+
+void BenchRestartCost(uint32_t threads) {
+  for (auto no_readers : {1U, threads}) {
+    RunRestartBenchmark<true>("throw RestartException", no_readers);
+    RunRestartBenchmark<false>("TryValidateOptimisticLock", no_readers);
+    if (threads == 1) { break; }
+  }
+}
+
+/* Bulk load, then every thread looks up all keys in its own random order */
+template <typename Container>
+void RunTreeBenchmark(const char *name, uint32_t threads) {
+  static constexpr unsigned NO_KEYS = 200000;
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  Container container(&epoch);
+  auto data = Generate(NO_KEYS);
+  Measure((std::string(name) + " insert").c_str(), NO_KEYS, [&]() {
+    for (auto key : data) { container.Insert(key); }
+  });
+  Measure((std::string(name) + " lookup").c_str(), threads * NO_KEYS, [&]() {
+    RunThreads(threads, [&](uint32_t tid) {
+      auto keys = data;
+      std::shuffle(keys.begin(), keys.end(), std::mt19937(tid));
+      unsigned result;
+      for (auto key : keys) { container.LookUp(key, result); }
+    });
+  });
+}
+
+/* The B+-tree against the skip list, the other O(log n) structure */
+void BenchBTree(uint32_t threads) {
+  RunTreeBenchmark<OptimisticBTree<unsigned>>("OptimisticBTree", threads);
+  RunTreeBenchmark<OptimisticSkipList<unsigned>>("OptimisticSkipList", threads);
+}
+
+/* Searches within one node-sized array: scalar binary search vs the vector kernel */
+template <typename K>
+void RunKeySearchBenchmark(uint32_t count) {
+  static constexpr unsigned NO_SEARCHES = 1000000;
+  std::vector<K> keys(count);
+  std::iota(keys.begin(), keys.end(), 0);
+  for (auto &key : keys) { key *= 2; }
+  std::vector<K> probes(1024);
+  std::mt19937 rng(42);
+  for (auto &probe : probes) { probe = rng() % (2 * count); }
+
+  auto measure = [&](const char *kernel, auto &&search) {
+    auto label        = std::to_string(sizeof(K) * 8) + " bit keys, " + std::to_string(count) + " per node, " + kernel;
+    uint64_t checksum = 0;
+    Measure(label.c_str(), NO_SEARCHES, [&]() {
+      for (auto idx = 0U; idx < NO_SEARCHES; idx++) { checksum += search(keys.data(), count, probes[idx % 1024]); }
+    });
+    return checksum;
+  };
+  auto scalar = measure("scalar", ScalarLowerBound<K>);
+  auto vector = measure(SIMD_ISA, KeyLowerBound<K>);
+  if (scalar != vector) { std::cout << "    MISMATCH between the scalar and the vector search" << std::endl; }
+}
+
+void BenchKeySearch(uint32_t) {
+  for (uint32_t count : {16, 64, 256}) {
+    RunKeySearchBenchmark<uint32_t>(count);
+    RunKeySearchBenchmark<uint64_t>(count);
+  }
+}
+
+/**
+ * EpochGuard enter/exit throughput, which is what every LookUp pays.
+ * `PACKED` is the former layout where eight workers share a cache line of local epochs
+ */
+template <bool PACKED>
+void RunGuardBenchmark(uint32_t no_workers) {
+  static constexpr unsigned NO_GUARDS = 2000000;
+  EpochHandler man(no_workers);
+  std::vector<std::atomic<uint64_t>> packed_epochs(no_workers);
+  auto label = std::string(PACKED ? "packed" : "padded") + " local epochs x" + std::to_string(no_workers);
+  Measure(label.c_str(), no_workers * NO_GUARDS, [&]() {
+    std::vector<std::thread> threads;
+    for (auto tid = 0U; tid < no_workers; tid++) {
+      threads.emplace_back([&, thread_id = tid]() {
+        auto slot = PACKED ? &packed_epochs[thread_id] : &man.LocalEpoch(thread_id);
+        for (auto op = 0U; op < NO_GUARDS; op++) { EpochGuard ep(slot, man.global_epoch); }
+      });
+    }
+    for (auto &thread : threads) { thread.join(); }
+  });
+}
+
+void BenchEpochGuards(uint32_t threads) {
+  RunGuardBenchmark<true>(threads);
+  RunGuardBenchmark<false>(threads);
+}
+
+struct MicroBenchmark {
+  const char *name;
+  void (*run)(uint32_t threads);
+};
+
+static constexpr MicroBenchmark MICRO_BENCHMARKS[] = {
+  {"allocator", BenchAllocator},
+  {"lookup-batch", BenchLookUpBatch},
+  {"ingest", BenchIngest},
+  {"restart-policy", BenchRestartPolicy},
+  {"split-layout", BenchSplitLayout},
+  {"unrolled", BenchUnrolled},
+  {"prefetch", BenchPrefetch},
+  {"lock-shared", BenchLockShared},
+  {"lock-contention", BenchLockContention},
+  {"restart-cost", BenchRestartCost},
+  {"btree", BenchBTree},
+  {"key-search", BenchKeySearch},
+  {"epoch-guards", BenchEpochGuards},
+};
+
+void RunMicroBenchmarks(const std::string &filter, uint32_t threads) {
+  std::cout << threads << " threads" << std::endl;
+  if (!PerfEvent().Available()) {
+    std::cout << "perf_event unavailable, cache misses are reported as nan" << std::endl;
+  }
+  for (const auto &benchmark : MICRO_BENCHMARKS) {
+    if (std::string(benchmark.name).find(filter) == std::string::npos) { continue; }
+    std::cout << benchmark.name << std::endl;
+    benchmark.run(threads);
+  }
+}
+
+auto main(int argc, char **argv) -> int {
+  auto config    = ParseArguments(argc, argv);
+  auto &workload = config.workload;
+  if (config.micro) {
+    RunMicroBenchmarks(*config.micro, workload.threads);
+    return 0;
+  }
+  static constexpr const char *DISTRIBUTIONS[] = {"uniform", "zipfian", "latest"};
+  std::cout << workload.threads << " threads, " << workload.duration_ms << "ms, " << workload.keys << " keys ("
+            << DISTRIBUTIONS[static_cast<int>(workload.distribution)] << "), mix lookup/insert/delete/scan "
+            << workload.lookups << "/" << workload.inserts << "/" << workload.deletes << "/" << workload.scans
+            << std::endl;
+  if (!PerfEvent().Available()) {
+    std::cout << "perf_event unavailable, hardware counters are reported as nan" << std::endl;
+  }
+  if constexpr (!STATS_ENABLED) { std::cout << "Restarts are counted with -DENABLE_STATS=ON" << std::endl; }
+
+  {
+    MutexSortedList<uint64_t> list;
+    Run("MutexSortedList", list, config);
+  }
+  {
+    EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+    epoch.StartReclaimer();
+    OptimisticSortedList<uint64_t> list(&epoch);
+    Run("OptimisticSortedList", list, config);
+  }
+  {
+    HazardPointerHandler hazard;
+    OptimisticSortedList<uint64_t, PoolAllocator, HazardPointerHandler> list(&hazard);
+    Run("OptimisticSortedList/HP", list, config);
+  }
+  {
+    EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+    epoch.StartReclaimer();
+    OptimisticSortedList<uint64_t, MallocAllocator, EpochHandler, InlineKey<uint64_t>, ScalableHybridLock> list(
+      &epoch);
+    Run("OptimisticSortedList/BRLock", list, config);
+  }
+  {
+    EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+    epoch.StartReclaimer();
+    LockCouplingSortedList<uint64_t> list(&epoch);
+    Run("LockCouplingSortedList", list, config);
+  }
+  {
+    EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+    epoch.StartReclaimer();
+    LockFreeSortedList<uint64_t> list(&epoch);
+    Run("LockFreeSortedList", list, config);
+  }
+  {
+    EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+    epoch.StartReclaimer();
+    OptimisticSkipList<uint64_t> list(&epoch);
+    Run("OptimisticSkipList", list, config);
+  }
+  {
+    EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+    epoch.StartReclaimer();
+    UnrolledSortedList<uint64_t> list(&epoch);
+    Run("UnrolledSortedList", list, config);
+  }
+  {
+    EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+    epoch.StartReclaimer();
+    OptimisticBTree<uint64_t> tree(&epoch);
+    Run("OptimisticBTree", tree, config);
+  }
+  return 0;
+}
\ No newline at end of file
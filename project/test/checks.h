@@ -0,0 +1,120 @@
+#pragma once
+
+#include "common/utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * Checks shared by the tests of the SortedList implementations, for any `List` with Insert/LookUp/Delete on
+ *  unsigned keys. Like CheckKeySearch in tree.cc, they count failed expectations in `*failures`
+ *  and the test asserts that there were none
+ */
+
+inline auto Generate(unsigned n) -> std::vector<unsigned> {
+  std::vector<unsigned> data(n);
+  std::iota(data.begin(), data.end(), 0);
+  std::shuffle(data.begin(), data.end(), std::mt19937(42));
+  return data;
+}
+
+/* Insert [0, no_keys) in random order plus one duplicate, look every key up, then delete the even ones */
+template <typename List>
+void CheckSingleThread(List &list, unsigned no_keys, int *failures) {
+  auto data = Generate(no_keys);
+  for (auto key : data) { list.Insert(key); }
+  list.Insert(data[0]);
+
+  unsigned result;
+  for (unsigned key = 0; key < no_keys; key++) {
+    if (!list.LookUp(key, result) || result != key) { (*failures)++; }
+  }
+  if (list.LookUp(no_keys, result)) { (*failures)++; }
+
+  for (unsigned key = 0; key < no_keys; key += 2) {
+    if (!list.Delete(key)) { (*failures)++; }
+  }
+  if (list.Delete(0)) { (*failures)++; }
+  for (unsigned key = 0; key < no_keys; key++) {
+    if (list.LookUp(key, result) != (key % 2 == 1)) { (*failures)++; }
+  }
+}
+
+/**
+ * Every thread owns the keys `tid + k * threads`, so the writers interleave across the whole structure.
+ * A thread churns its keys `rounds` times (insert, look up, delete), inserts them once more and deletes every other
+ *  one: afterwards exactly the keys with `key % (2 * threads) >= threads` are left
+ */
+template <typename List>
+void CheckDisjointWriters(List &list, unsigned threads, unsigned no_keys, unsigned rounds, int *failures) {
+  std::atomic<int> failed = 0;
+  std::vector<std::thread> workers;
+  for (unsigned tid = 0; tid < threads; tid++) {
+    workers.emplace_back([&, tid]() {
+      FinalProject::InitializeThread();
+      unsigned result;
+      for (unsigned round = 0; round <= rounds; round++) {
+        for (unsigned key = tid; key < no_keys; key += threads) { list.Insert(key); }
+        for (unsigned key = tid; key < no_keys; key += threads) {
+          if (!list.LookUp(key, result)) { failed++; }
+        }
+        if (round == rounds) { break; }
+        for (unsigned key = tid; key < no_keys; key += threads) {
+          if (!list.Delete(key)) { failed++; }
+        }
+      }
+      for (unsigned key = tid; key < no_keys; key += 2 * threads) {
+        if (!list.Delete(key)) { failed++; }
+      }
+    });
+  }
+  for (auto &worker : workers) { worker.join(); }
+
+  unsigned result;
+  for (unsigned key = 0; key < no_keys; key++) {
+    if (list.LookUp(key, result) != (key % (2 * threads) >= threads)) { failed++; }
+  }
+  *failures += failed.load();
+}
+
+/**
+ * Readers and writers on the same keys. The even keys are loaded up front and only ever overwritten with an equal
+ *  value, the odd keys are inserted and deleted over and over by all writers at once.
+ * A reader must find every even key and may miss an odd one, but never sees a wrong value
+ */
+template <typename List>
+void CheckReadersAndWriters(List &list, unsigned threads, unsigned no_keys, unsigned rounds, int *failures) {
+  for (unsigned key = 0; key < no_keys; key += 2) { list.Insert(key); }
+
+  std::atomic<int> failed = 0;
+  std::vector<std::thread> workers;
+  for (unsigned tid = 0; tid < threads; tid++) {
+    workers.emplace_back([&, tid]() {
+      FinalProject::InitializeThread();
+      unsigned result;
+      for (unsigned round = 0; round < rounds; round++) {
+        for (unsigned key = 0; key < no_keys; key++) {
+          if (tid % 2 == 0) {
+            list.Insert(key);
+            if (key % 2 == 1) { list.Delete(key); }
+          } else {
+            auto found = list.LookUp(key, result);
+            if ((key % 2 == 0 && !found) || (found && result != key)) { failed++; }
+          }
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) { worker.join(); }
+
+  // The last operation of every writer on an odd key was a Delete
+  unsigned result;
+  for (unsigned key = 0; key < no_keys; key++) {
+    if (list.LookUp(key, result) != (key % 2 == 0)) { failed++; }
+  }
+  *failures += failed.load();
+}
@@ -1,5 +1,6 @@
 #include <semaphore>
 #include <array>
+#include <chrono>
 #include <iostream>
 #include <random>
 #include <thread>
@@ -9,6 +10,7 @@
 #include "common/utils.h"
 #include "sync/epoch.h"
 #include "sync/guard.h"
+#include "sync/hazard.h"
 
 static constexpr int NO_THREADS = 10;
 static constexpr int NO_ENTRIES = 10000;
@@ -101,7 +103,7 @@ UTEST(TestEpoch, NormalOperation) {
         man.FreeOutdatedPtr(thread_id);
 
         {
-          EpochGuard ep(&(man.local_epoch[thread_id]), man.global_epoch);
+          EpochGuard ep(&man.LocalEpoch(thread_id), man.global_epoch);
 
           /* All ptrs of current epoch should be fine to read */
           for (auto t_id = 0; t_id < NO_THREADS; t_id++) {
@@ -129,20 +131,111 @@ UTEST(TestEpoch, NormalOperation) {
     for (int tid = 0; tid < NO_THREADS; tid++) { signal_main_to_thread[tid].release(); }
 
     /* Wait until all workers complete this epoch */
-    for (int tid = 0; tid < NO_THREADS; tid++) { signal_main_to_thread[tid].acquire(); }
+    for (int tid = 0; tid < NO_THREADS; tid++) { signal_thread_to_main[tid].acquire(); }
 
     /* Every defer list should have not more than two pointers */
     std::atomic_thread_fence(std::memory_order_seq_cst);
-    for (auto &ptr_list : man.to_free_ptr) { ASSERT_TRUE(ptr_list.size() <= 2); }
+    for (int tid = 0; tid < NO_THREADS; tid++) { ASSERT_TRUE(man.ToFreePtr(tid).size() <= 2); }
   }
 
   for (auto &thread : threads) { thread.join(); }
 
   /* AdvanceGlobalEpoch() was called NO_ENTRIES times */
   ASSERT_EQ(man.global_epoch.load(), NO_ENTRIES);
-  for (auto &ptr_list : man.to_free_ptr) { ASSERT_TRUE(ptr_list.size() <= 2); }
+  for (int tid = 0; tid < NO_THREADS; tid++) { ASSERT_TRUE(man.ToFreePtr(tid).size() <= 2); }
 
   /* Epoch handler destructor should automatically reclaim all un-deleted ptrs */
 }
 
+UTEST(TestEpoch, BackgroundReclaimer) {
+  static constexpr uint64_t NODE_SIZE = 64;
+  EpochHandler man(NO_THREADS);
+  man.StartReclaimer({std::chrono::milliseconds(1), 64 * NODE_SIZE});
+
+  std::thread threads[NO_THREADS];
+  for (int tid = 0; tid < NO_THREADS; tid++) {
+    threads[tid] = std::thread([&, thread_id = tid]() {
+      for (auto idx = 0; idx < NO_ENTRIES; idx++) {
+        EpochGuard ep(&man.LocalEpoch(thread_id), man.global_epoch);
+        man.DeferFreePointer(thread_id, malloc(NODE_SIZE), NODE_SIZE);
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+
+  /* No worker ever called FreeOutdatedPtr(), the reclaimer drains everything once all guards are gone */
+  for (auto wait = 0; wait < 1000 && man.RetiredBytes() > 0; wait++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(man.RetiredBytes(), 0U);
+  EXPECT_GT(man.global_epoch.load(), 0U);
+  man.StopReclaimer();
+}
+
+UTEST(TestEpoch, ThreadRegistration) {
+  static constexpr int NO_WAVES   = 4;
+  static constexpr int NO_WORKERS = 200;  // More than the records allocated up front
+  EpochHandler man;
+  std::atomic<int> max_id = 0;
+
+  /* Short-lived workers, every wave reuses the ids of the previous one */
+  for (auto wave = 0; wave < NO_WAVES; wave++) {
+    std::vector<std::thread> threads;
+    std::atomic<int> ready = 0;
+    for (auto idx = 0; idx < NO_WORKERS; idx++) {
+      threads.emplace_back([&]() {
+        FinalProject::InitializeThread();
+        auto tid = FinalProject::thread_id;
+        for (auto seen = max_id.load(); seen < tid && !max_id.compare_exchange_weak(seen, tid);) {}
+        /* Keep all workers of the wave alive at the same time */
+        ready++;
+        while (ready.load() < NO_WORKERS) { std::this_thread::yield(); }
+        {
+          EpochGuard ep(&man.LocalEpoch(tid), man.global_epoch);
+          man.DeferFreePointer(tid, malloc(64), 64);
+        }
+        man.FreeOutdatedPtr(tid);
+      });
+    }
+    for (auto &thread : threads) { thread.join(); }
+    man.AdvanceGlobalEpoch();
+  }
+
+  /* The main thread may hold an id as well */
+  EXPECT_LE(max_id.load(), NO_WORKERS);
+  EXPECT_GE(man.Capacity(), static_cast<uint64_t>(NO_WORKERS));
+}
+
+UTEST(TestHazardPointer, StalledReader) {
+  using HazardPointerHandler = FinalProject::HazardPointerHandler;
+  HazardPointerHandler man(NO_THREADS);
+  auto pinned = malloc(64);
+  std::atomic<bool> published = false;
+  std::atomic<bool> done      = false;
+
+  /* A reader protects one node and then stalls until the end of the test */
+  std::thread reader([&]() {
+    HazardPointerHandler::Guard guard(&man, 1);
+    guard.Protect(0, pinned);
+    published = true;
+    while (!done.load()) { std::this_thread::yield(); }
+  });
+  while (!published.load()) { std::this_thread::yield(); }
+
+  /* Unlike an EpochGuard, the stalled reader only pins the node it published */
+  man.DeferFreePointer(0, pinned, 64);
+  for (auto idx = 0; idx < NO_ENTRIES; idx++) {
+    man.DeferFreePointer(0, malloc(64), 64);
+    ASSERT_LT(man.ToFreePtr(0).size(), man.ScanThreshold());
+  }
+  man.FreeOutdatedPtr(0);
+  ASSERT_EQ(man.ToFreePtr(0).size(), 1U);
+  ASSERT_EQ(man.ToFreePtr(0)[0].ptr, pinned);
+
+  done = true;
+  reader.join();
+  man.FreeOutdatedPtr(0);
+  ASSERT_EQ(man.ToFreePtr(0).size(), 0U);
+}
+
 UTEST_MAIN();
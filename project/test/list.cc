@@ -0,0 +1,775 @@
+#include "common/utest.h"
+#include "common/utils.h"
+#include "list/list.h"
+#include "list/lock_free_list.h"
+#include "list/skip_list.h"
+#include "list/unrolled_list.h"
+#include "list/workload.h"
+#include "sync/hazard.h"
+#include "sync/scalable_lock.h"
+#include "../src/list/list.cc"
+#include "../src/list/lock_free_list.cc"
+#include "../src/list/skip_list.cc"
+#include "../src/list/unrolled_list.cc"
+#include "checks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr int NO_THREADS = 8;
+static constexpr int NO_OPS     = 1000;
+
+using namespace FinalProject;
+
+/* Fat value ordered by a small key, the case the split node layout is meant for */
+struct Student {
+  unsigned id{0};
+  std::string name;
+  uint8_t semester{0};
+
+  auto operator<=>(const Student &other) const { return id <=> other.id; }
+  auto operator==(const Student &other) const -> bool { return id == other.id; }
+};
+
+struct StudentId {
+  auto operator()(const Student &student) const -> unsigned { return student.id; }
+};
+
+auto MakeStudent(unsigned id, uint8_t semester = 1) -> Student {
+  return {id, "student with a name longer than the small string buffer " + std::to_string(id), semester};
+}
+
+/* Inserting the key of the first node again used to dereference its (missing) predecessor */
+UTEST(TestMutexSortedList, DuplicateHead) {
+  MutexSortedList<Student> list;
+  list.Insert(MakeStudent(1, 1));
+  list.Insert(MakeStudent(2, 1));
+  list.Insert(MakeStudent(1, 5));
+
+  Student result;
+  ASSERT_TRUE(list.LookUp(MakeStudent(1), result));
+  ASSERT_EQ(result.semester, 5);
+  ASSERT_TRUE(list.LookUp(MakeStudent(2), result));
+  ASSERT_EQ(result.semester, 1);
+}
+
+UTEST(TestMutexSortedList, PooledNodes) {
+  // Values owning heap memory, deleted nodes are destroyed before they go back to the pool
+  MutexSortedList<Student, PoolAllocator> list;
+  for (unsigned id = 0; id < NO_OPS; id++) { list.Insert(MakeStudent(id)); }
+  for (unsigned id = 0; id < NO_OPS; id += 2) { ASSERT_TRUE(list.Delete(MakeStudent(id))); }
+  for (unsigned id = 0; id < NO_OPS; id += 2) { list.Insert(MakeStudent(id, 2)); }
+
+  Student result;
+  for (unsigned id = 0; id < NO_OPS; id++) {
+    ASSERT_TRUE(list.LookUp(MakeStudent(id), result));
+    ASSERT_TRUE(result.name == MakeStudent(id).name);
+    ASSERT_EQ(result.semester, (id % 2 == 0) ? 2 : 1);
+  }
+}
+
+UTEST(TestPoolAllocator, NaturalAlignment) {
+  // Sizes of over-aligned nodes: a block must be aligned to its size's largest power of two, up to 64
+  for (uint64_t size : {0, 8, 32, 48, 64, 96, 128, 192, 320, 1024, 4096}) {
+    auto alignment = std::min<uint64_t>(std::max<uint64_t>(size & (~size + 1), 16), PoolAllocator::MAX_ALIGNMENT);
+    void *blocks[3];
+    for (auto &block : blocks) {
+      block = PoolAllocator::Allocate(size);
+      ASSERT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0U);
+    }
+    for (auto &block : blocks) { PoolAllocator::Deallocate(block, size); }
+  }
+}
+
+UTEST(TestOptimisticSortedList, DuplicateHead) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<Student> list(&epoch);
+  list.Insert(MakeStudent(1, 1));
+  list.Insert(MakeStudent(2, 1));
+  list.Insert(MakeStudent(1, 5));
+
+  Student result;
+  ASSERT_TRUE(list.LookUp(MakeStudent(1), result));
+  ASSERT_EQ(result.semester, 5);
+  ASSERT_TRUE(list.LookUp(MakeStudent(2), result));
+  ASSERT_EQ(result.semester, 1);
+}
+
+UTEST(TestLockCouplingSortedList, SingleThread) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  LockCouplingSortedList<unsigned> list(&epoch);
+  int failures = 0;
+  CheckSingleThread(list, NO_OPS, &failures);
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST(TestLockCouplingSortedList, DisjointWriters) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  LockCouplingSortedList<unsigned> list(&epoch);
+  int failures = 0;
+  CheckDisjointWriters(list, NO_THREADS, NO_OPS, 0, &failures);
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST(TestLockCouplingSortedList, ReadersAndWriters) {
+  // Readers couple through the very nodes the writers overwrite, link and unlink
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  LockCouplingSortedList<unsigned> list(&epoch);
+  int failures = 0;
+  CheckReadersAndWriters(list, NO_THREADS, NO_OPS, 5, &failures);
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST(TestLockCouplingSortedList, HazardPointers) {
+  // Same workload as DisjointWriters, plus churn on the odd keys so that deleted nodes are freed during traversals
+  HazardPointerHandler hazard;
+  LockCouplingSortedList<unsigned, MallocAllocator, HazardPointerHandler> list(&hazard);
+
+  std::thread threads[NO_THREADS];
+  for (auto idx = 0; idx < NO_THREADS; idx++) {
+    threads[idx] = std::thread([&, tid = idx]() {
+      InitializeThread();
+      unsigned result;
+      for (auto round = 0; round < 10; round++) {
+        for (unsigned key = tid; key < NO_OPS; key += NO_THREADS) { list.Insert(key); }
+        for (unsigned key = tid; key < NO_OPS; key += NO_THREADS) { EXPECT_TRUE(list.LookUp(key, result)); }
+        for (unsigned key = tid; key < NO_OPS; key += NO_THREADS) { EXPECT_TRUE(list.Delete(key)); }
+      }
+      // Retire lists are bounded even though no one ever calls FreeOutdatedPtr()
+      EXPECT_LT(hazard.ToFreePtr(thread_id).size(), hazard.ScanThreshold());
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+
+  unsigned result;
+  for (unsigned key = 0; key < NO_OPS; key++) { ASSERT_FALSE(list.LookUp(key, result)); }
+}
+
+UTEST(TestOptimisticSortedList, HazardPointers) {
+  HazardPointerHandler hazard;
+  OptimisticSortedList<unsigned, MallocAllocator, HazardPointerHandler> list(&hazard);
+  for (unsigned key = 0; key < NO_OPS; key += 2) { list.Insert(key); }
+
+  std::thread threads[NO_THREADS];
+  for (auto idx = 0; idx < NO_THREADS; idx++) {
+    threads[idx] = std::thread([&, tid = idx]() {
+      InitializeThread();
+      unsigned result;
+      if (tid % 2 == 0) {
+        for (auto round = 0; round < 10; round++) {
+          for (unsigned key = tid + 1; key < NO_OPS; key += NO_THREADS) { list.Insert(key); }
+          for (unsigned key = tid + 1; key < NO_OPS; key += NO_THREADS) { list.Delete(key); }
+        }
+      } else {
+        for (unsigned key = 0; key < NO_OPS; key += 2) { EXPECT_TRUE(list.LookUp(key, result)); }
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+
+  unsigned result;
+  for (unsigned key = 0; key < NO_OPS; key++) { ASSERT_EQ(list.LookUp(key, result), key % 2 == 0); }
+}
+
+UTEST(TestOptimisticSortedList, ConcurrentReadersAndWriters) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned> list(&epoch);
+  for (unsigned key = 0; key < NO_OPS; key += 2) { list.Insert(key); }
+
+  std::thread threads[NO_THREADS];
+  for (auto idx = 0; idx < NO_THREADS; idx++) {
+    threads[idx] = std::thread([&, tid = idx]() {
+      InitializeThread();
+      unsigned result;
+      if (tid % 2 == 0) {
+        for (unsigned key = tid + 1; key < NO_OPS; key += NO_THREADS) { list.Insert(key); }
+      } else {
+        // Even keys are never modified, so they must always be found
+        for (unsigned key = 0; key < NO_OPS; key += 2) { EXPECT_TRUE(list.LookUp(key, result)); }
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+
+  unsigned result;
+  for (unsigned key = 0; key < NO_OPS; key++) {
+    ASSERT_EQ(list.LookUp(key, result), key % 2 == 0 || ((key - 1) % NO_THREADS) % 2 == 0);
+  }
+}
+
+UTEST(TestOptimisticSortedList, LookUpBatch) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned> list(&epoch);
+  for (unsigned key = 0; key < NO_OPS; key += 2) { list.Insert(key); }
+
+  // Unsorted probes with duplicates, half of them missing
+  auto keys = Generate(NO_OPS);
+  keys.push_back(keys[0]);
+  std::vector<unsigned> results(keys.size());
+  std::unique_ptr<bool[]> found(new bool[keys.size()]);
+  auto no_found = list.LookUpBatch(keys, results, {found.get(), keys.size()});
+
+  EXPECT_EQ(no_found, uint64_t{NO_OPS / 2} + (keys[0] % 2 == 0));
+  for (auto idx = 0U; idx < keys.size(); idx++) {
+    ASSERT_EQ(found[idx], keys[idx] % 2 == 0);
+    if (found[idx]) { ASSERT_EQ(results[idx], keys[idx]); }
+  }
+}
+
+UTEST(TestOptimisticSortedList, LookUpBatchWithWriters) {
+  // Writers keep bumping the version, the batch has to shrink until it gets through
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned> list(&epoch);
+  for (unsigned key = 0; key < NO_OPS; key += 2) { list.Insert(key); }
+
+  std::vector<unsigned> keys(NO_OPS / 2);
+  for (auto idx = 0U; idx < keys.size(); idx++) { keys[idx] = 2 * idx; }
+
+  std::atomic<bool> done = false;
+  std::thread writer([&]() {
+    InitializeThread();
+    for (unsigned key = 1; !done.load(); key = (key + 2) % NO_OPS) {
+      list.Insert(key);
+      list.Delete(key);
+    }
+  });
+  std::thread threads[NO_THREADS];
+  for (auto &thread : threads) {
+    thread = std::thread([&]() {
+      InitializeThread();
+      std::vector<unsigned> results(keys.size());
+      std::unique_ptr<bool[]> found(new bool[keys.size()]);
+      for (auto round = 0; round < 20; round++) {
+        EXPECT_EQ(list.LookUpBatch(keys, results, {found.get(), keys.size()}), keys.size());
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+  done = true;
+  writer.join();
+}
+
+UTEST(TestOptimisticSortedList, InsertDeleteBatch) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned> list(&epoch);
+  list.Insert(NO_OPS / 2);
+
+  // Unsorted, with a duplicate and a key which is already in the list
+  auto keys = Generate(NO_OPS);
+  keys.push_back(keys[0]);
+  list.InsertBatch(keys);
+  unsigned result;
+  for (unsigned key = 0; key < NO_OPS; key++) { ASSERT_TRUE(list.LookUp(key, result)); }
+
+  std::vector<unsigned> victims;
+  for (unsigned key = 0; key < NO_OPS + 10; key += 2) { victims.push_back(key); }
+  std::shuffle(victims.begin(), victims.end(), std::mt19937(7));
+  ASSERT_EQ(list.DeleteBatch(victims), uint64_t{NO_OPS / 2});
+  for (unsigned key = 0; key < NO_OPS; key++) { ASSERT_EQ(list.LookUp(key, result), key % 2 == 1); }
+  ASSERT_EQ(list.DeleteBatch(victims), 0U);
+}
+
+UTEST(TestOptimisticSortedList, Scan) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned> list(&epoch);
+  for (auto key : Generate(NO_OPS)) { list.Insert(key); }
+
+  std::vector<unsigned> values;
+  ASSERT_EQ(list.Scan(100, 300, [&](unsigned value) {
+    values.push_back(value);
+    return true;
+  }), 200U);
+  ASSERT_EQ(values.size(), 200U);
+  for (auto idx = 0U; idx < values.size(); idx++) { ASSERT_EQ(values[idx], 100 + idx); }
+
+  // Copy-out stops once the buffer is full, an empty range visits nothing
+  std::vector<unsigned> out(10);
+  ASSERT_EQ(list.Scan(NO_OPS - 5, NO_OPS + 5, out), 5U);
+  ASSERT_EQ(out[0], unsigned{NO_OPS - 5});
+  ASSERT_EQ(list.Scan(0, NO_OPS, out), out.size());
+  ASSERT_EQ(out.back(), out.size() - 1);
+  ASSERT_EQ(list.Scan(NO_OPS, 2 * NO_OPS, out), 0U);
+}
+
+UTEST(TestOptimisticSortedList, ScanWithWriters) {
+  // Even keys are stable, odd keys churn: every scan sees all even keys, in order and exactly once
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned> list(&epoch);
+  for (unsigned key = 0; key < NO_OPS; key += 2) { list.Insert(key); }
+
+  std::atomic<bool> done = false;
+  std::thread writer([&]() {
+    InitializeThread();
+    for (unsigned key = 1; !done.load(); key = (key + 2) % NO_OPS) {
+      list.Insert(key);
+      list.Delete(key);
+    }
+  });
+  std::thread threads[NO_THREADS];
+  for (auto &thread : threads) {
+    thread = std::thread([&]() {
+      InitializeThread();
+      for (auto round = 0; round < 20; round++) {
+        unsigned expected = 0;
+        list.Scan(0, NO_OPS, [&](unsigned value) {
+          if (value % 2 == 1) { return true; }
+          if (value != expected) { return false; }
+          expected += 2;
+          return true;
+        });
+        EXPECT_EQ(expected, unsigned{NO_OPS});
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+  done = true;
+  writer.join();
+}
+
+UTEST(TestOptimisticSortedList, BoundedRestarts) {
+  // A zero budget turns every LookUp and batch into a SHARED acquisition, which must still see every even key
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned> list(&epoch, RestartPolicy{0, false});
+  for (unsigned key = 0; key < NO_OPS; key += 2) { list.Insert(key); }
+  std::vector<unsigned> keys(NO_OPS / 2);
+  for (auto idx = 0U; idx < keys.size(); idx++) { keys[idx] = 2 * idx; }
+
+  std::atomic<bool> done = false;
+  std::thread writer([&]() {
+    InitializeThread();
+    for (unsigned key = 1; !done.load(); key = (key + 2) % NO_OPS) {
+      list.Insert(key);
+      list.Delete(key);
+    }
+  });
+  std::thread threads[NO_THREADS];
+  for (auto &thread : threads) {
+    thread = std::thread([&]() {
+      InitializeThread();
+      unsigned result;
+      for (unsigned key = 0; key < NO_OPS; key += 2) { EXPECT_TRUE(list.LookUp(key, result)); }
+      std::vector<unsigned> results(keys.size());
+      std::unique_ptr<bool[]> found(new bool[keys.size()]);
+      EXPECT_EQ(list.LookUpBatch(keys, results, {found.get(), keys.size()}), keys.size());
+      EXPECT_TRUE(results == keys);
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+  done = true;
+  writer.join();
+}
+
+UTEST(TestOptimisticSortedList, ScalableLock) {
+  // Same as BoundedRestarts, the SHARED readers now register in the per-thread slots of the list lock
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned, MallocAllocator, EpochHandler, InlineKey<unsigned>, ScalableHybridLock> list(
+    &epoch, RestartPolicy{0, false});
+  for (unsigned key = 0; key < NO_OPS; key += 2) { list.Insert(key); }
+
+  std::atomic<bool> done = false;
+  std::thread writer([&]() {
+    InitializeThread();
+    for (unsigned key = 1; !done.load(); key = (key + 2) % NO_OPS) {
+      list.Insert(key);
+      list.Delete(key);
+    }
+  });
+  std::thread threads[NO_THREADS];
+  for (auto &thread : threads) {
+    thread = std::thread([&]() {
+      InitializeThread();
+      unsigned result;
+      for (unsigned key = 0; key < NO_OPS; key += 2) { EXPECT_TRUE(list.LookUp(key, result)); }
+      EXPECT_GE(list.Scan(0, NO_OPS, [](unsigned) { return true; }), uint64_t{NO_OPS / 2});
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+  done = true;
+  writer.join();
+}
+
+UTEST(TestOptimisticSortedList, SplitLayout) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<Student, MallocAllocator, EpochHandler, SplitKey<Student, StudentId>> list(&epoch);
+  for (auto key : Generate(NO_OPS)) { list.Insert(MakeStudent(key)); }
+
+  Student result;
+  for (unsigned key = 0; key < NO_OPS; key++) {
+    ASSERT_TRUE(list.LookUp(MakeStudent(key), result));
+    ASSERT_TRUE(result.name == MakeStudent(key).name);
+  }
+  // An update replaces the node, the payload of the old one is retired with it
+  list.Insert(MakeStudent(7, 2));
+  EXPECT_TRUE(list.LookUp(MakeStudent(7), result));
+  EXPECT_EQ(result.semester, 2);
+
+  std::vector<Student> range(10);
+  EXPECT_EQ(list.Scan(MakeStudent(100), MakeStudent(200), range), 10U);
+  EXPECT_EQ(range.back().id, 109U);
+  for (unsigned key = 0; key < NO_OPS; key += 2) { EXPECT_TRUE(list.Delete(MakeStudent(key))); }
+  for (unsigned key = 0; key < NO_OPS; key++) { ASSERT_EQ(list.LookUp(MakeStudent(key), result), key % 2 == 1); }
+}
+
+UTEST(TestOptimisticSortedList, SplitLayoutPrefixKeys) {
+  // Strings sharing their first 8 bytes tie on the key and are told apart by the payload
+  HazardPointerHandler hazard;
+  OptimisticSortedList<std::string, MallocAllocator, HazardPointerHandler, SplitKey<std::string, StringPrefix, false>>
+    list(&hazard);
+  std::vector<std::string> values;
+  for (auto key : Generate(NO_OPS)) { values.push_back("common prefix " + std::to_string(key)); }
+  values.push_back("a");
+  values.push_back(std::string("a\0", 2));
+  for (const auto &value : values) { list.Insert(value); }
+
+  std::thread threads[NO_THREADS];
+  for (auto idx = 0; idx < NO_THREADS; idx++) {
+    threads[idx] = std::thread([&, tid = idx]() {
+      InitializeThread();
+      std::string result;
+      for (auto round = 0; round < 10; round++) {
+        for (auto pos = tid; pos < NO_OPS; pos += NO_THREADS) {
+          if (tid % 2 == 0) {
+            list.Insert(values[pos]);
+          } else {
+            EXPECT_TRUE(list.LookUp(values[pos], result));
+            EXPECT_TRUE(result == values[pos]);
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+
+  std::string result;
+  for (const auto &value : values) { ASSERT_TRUE(list.LookUp(value, result)); }
+  EXPECT_FALSE(list.LookUp("common prefix", result));
+  std::vector<std::string> sorted(values.size());
+  EXPECT_EQ(list.Scan(std::string(), std::string("\xff"), sorted), values.size());
+  EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
+}
+
+/* Walk a chain the way the writers do, and check that every node points exactly DISTANCE nodes ahead */
+template <uint32_t DISTANCE>
+auto JumpsAreExact(JumpNode<unsigned> *head) -> bool {
+  std::vector<JumpNode<unsigned> *> nodes;
+  for (auto node = head; node != nullptr; node = node->next) { nodes.push_back(node); }
+  for (auto idx = 0U; idx < nodes.size(); idx++) {
+    auto expected = (idx + DISTANCE < nodes.size()) ? nodes[idx + DISTANCE] : nullptr;
+    if (nodes[idx]->jump != expected) { return false; }
+  }
+  return true;
+}
+
+UTEST(TestOptimisticSortedList, JumpPointers) {
+  using Key = JumpKey<unsigned, 3>;
+  std::vector<std::unique_ptr<JumpNode<unsigned>>> pool;
+  auto make = [&](unsigned value, JumpNode<unsigned> *next) {
+    pool.push_back(std::make_unique<JumpNode<unsigned>>(value, next));
+    return pool.back().get();
+  };
+  JumpNode<unsigned> *head = nullptr;
+  for (unsigned value = 20; value > 0; value -= 2) { head = make(value, head); }
+  Key::Window::Rebuild(head);
+  ASSERT_TRUE(JumpsAreExact<3>(head));
+
+  // Same window protocol as OptimisticSortedList::Insert() and Delete()
+  auto insert = [&](unsigned value) {
+    Key::Window window;
+    auto link = &head;
+    for (; *link != nullptr && (*link)->value < value; link = &(*link)->next) { window.Push(*link); }
+    *link = make(value, *link);
+    window.AfterInsert(*link);
+  };
+  auto erase = [&](unsigned value) {
+    Key::Window window;
+    auto link = &head;
+    for (; (*link)->value < value; link = &(*link)->next) { window.Push(*link); }
+    *link = (*link)->next;
+    window.AfterDelete(*link);
+  };
+  for (unsigned value : {0, 7, 21, 1, 13}) {
+    insert(value);
+    ASSERT_TRUE(JumpsAreExact<3>(head));
+  }
+  for (unsigned value : {0, 21, 8, 20, 1, 2}) {
+    erase(value);
+    ASSERT_TRUE(JumpsAreExact<3>(head));
+  }
+  while (head != nullptr) {
+    erase(head->value);
+    ASSERT_TRUE(JumpsAreExact<3>(head));
+  }
+}
+
+UTEST(TestOptimisticSortedList, PrefetchingReadersAndWriters) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<unsigned, MallocAllocator, EpochHandler, JumpKey<unsigned>> list(&epoch);
+  std::vector<unsigned> evens;
+  for (unsigned key = 0; key < NO_OPS; key += 2) { evens.push_back(key); }
+  list.InsertBatch(evens);
+
+  std::atomic<bool> done = false;
+  std::thread writer([&]() {
+    InitializeThread();
+    for (unsigned key = 1; key < NO_OPS; key += 2) { list.Insert(key); }
+    for (unsigned key = 1; key < NO_OPS; key += 4) { list.Delete(key); }
+    done = true;
+  });
+  std::thread readers[NO_THREADS - 1];
+  for (auto &reader : readers) {
+    reader = std::thread([&]() {
+      InitializeThread();
+      unsigned result;
+      while (!done.load()) {
+        for (unsigned key = 0; key < NO_OPS; key += 50) { EXPECT_TRUE(list.LookUp(key, result)); }
+      }
+    });
+  }
+  writer.join();
+  for (auto &reader : readers) { reader.join(); }
+
+  unsigned result;
+  for (unsigned key = 0; key < NO_OPS; key++) { ASSERT_EQ(list.LookUp(key, result), key % 4 != 1); }
+}
+
+/* Updates of existing keys race with readers: in place for a trivially copyable value, by node replacement otherwise */
+UTEST(TestOptimisticSortedList, FatValueUpdates) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  epoch.StartReclaimer({std::chrono::milliseconds(1), 4096});
+  OptimisticSortedList<Student> list(&epoch);
+  static_assert(InlineKey<Student>::IMMUTABLE && !InlineKey<unsigned>::IMMUTABLE);
+  for (unsigned id = 0; id < NO_OPS; id++) { list.Insert(MakeStudent(id)); }
+
+  std::atomic<bool> done = false;
+  std::thread writers[NO_THREADS / 2];
+  for (auto idx = 0; idx < NO_THREADS / 2; idx++) {
+    writers[idx] = std::thread([&, tid = idx]() {
+      InitializeThread();
+      for (auto round = 0; round < 20; round++) {
+        for (unsigned id = tid; id < NO_OPS; id += NO_THREADS / 2) { list.Insert(MakeStudent(id, round)); }
+      }
+    });
+  }
+  std::thread readers[NO_THREADS / 2];
+  for (auto &reader : readers) {
+    reader = std::thread([&]() {
+      InitializeThread();
+      Student result;
+      while (!done.load()) {
+        for (unsigned id = 0; id < NO_OPS; id += 7) {
+          EXPECT_TRUE(list.LookUp(MakeStudent(id), result));
+          EXPECT_TRUE(result.id == id && result.name == MakeStudent(id).name);
+        }
+      }
+    });
+  }
+  for (auto &writer : writers) { writer.join(); }
+  done = true;
+  for (auto &reader : readers) { reader.join(); }
+  epoch.StopReclaimer();
+
+  Student result;
+  for (unsigned id = 0; id < NO_OPS; id++) {
+    ASSERT_TRUE(list.LookUp(MakeStudent(id), result));
+    ASSERT_EQ(result.semester, 19);
+  }
+}
+
+/* A cache line wide value: a reader must never return a mix of two updates */
+struct Wide {
+  uint64_t key;
+  uint64_t words[7];
+
+  auto operator<=>(const Wide &other) const { return key <=> other.key; }
+};
+
+UTEST(TestOptimisticSortedList, SnapshotReads) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSortedList<Wide> list(&epoch);
+  auto make = [](uint64_t key, uint64_t version) {
+    Wide value{key, {}};
+    std::fill(std::begin(value.words), std::end(value.words), version);
+    return value;
+  };
+  for (uint64_t key = 0; key < 64; key++) { list.Insert(make(key, 0)); }
+
+  std::atomic<bool> done = false;
+  std::thread writer([&]() {
+    InitializeThread();
+    for (uint64_t version = 1; version < 2000; version++) { list.Insert(make(version % 64, version)); }
+    done = true;
+  });
+  std::thread readers[NO_THREADS - 1];
+  for (auto &reader : readers) {
+    reader = std::thread([&]() {
+      InitializeThread();
+      Wide result;
+      for (uint64_t key = 0; !done.load(); key = (key + 1) % 64) {
+        EXPECT_TRUE(list.LookUp(make(key, 0), result));
+        EXPECT_TRUE(std::all_of(std::begin(result.words), std::end(result.words),
+                                [&](uint64_t word) { return word == result.words[0]; }));
+      }
+    });
+  }
+  writer.join();
+  for (auto &reader : readers) { reader.join(); }
+}
+
+UTEST(TestLockFreeSortedList, SingleThread) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  LockFreeSortedList<unsigned> list(&epoch);
+  int failures = 0;
+  CheckSingleThread(list, NO_OPS, &failures);
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST(TestLockFreeSortedList, ConcurrentWriters) {
+  // Writers insert their own keys and keep overwriting a shared hot set while readers probe it
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  LockFreeSortedList<unsigned> list(&epoch);
+  for (unsigned key = 0; key < NO_OPS; key += NO_THREADS) { list.Insert(key); }
+
+  std::thread threads[NO_THREADS];
+  for (auto idx = 0; idx < NO_THREADS; idx++) {
+    threads[idx] = std::thread([&, tid = idx]() {
+      InitializeThread();
+      unsigned result;
+      for (unsigned key = tid; key < NO_OPS; key += NO_THREADS) {
+        if (tid != 0) { list.Insert(key); }
+        EXPECT_TRUE(list.LookUp(key - tid, result));
+        list.Insert(key - tid);
+      }
+      for (unsigned key = tid; key < NO_OPS; key += 2 * NO_THREADS) {
+        if (tid != 0) { EXPECT_TRUE(list.Delete(key)); }
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+
+  unsigned result;
+  for (unsigned key = 0; key < NO_OPS; key++) {
+    auto owner = key % NO_THREADS;
+    ASSERT_EQ(list.LookUp(key, result), owner == 0 || (key % (2 * NO_THREADS)) >= NO_THREADS);
+  }
+}
+
+UTEST(TestOptimisticSkipList, SingleThread) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSkipList<unsigned> list(&epoch);
+  int failures = 0;
+  CheckSingleThread(list, NO_OPS, &failures);
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST(TestOptimisticSkipList, DisjointWriters) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSkipList<unsigned> list(&epoch);
+  int failures = 0;
+  CheckDisjointWriters(list, NO_THREADS, NO_OPS, 0, &failures);
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST(TestOptimisticSkipList, ReadersAndWriters) {
+  // Towers of the odd keys are linked and unlinked under the readers of their neighbours
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticSkipList<unsigned> list(&epoch);
+  int failures = 0;
+  CheckReadersAndWriters(list, NO_THREADS, NO_OPS, 5, &failures);
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST(TestOptimisticSkipList, PooledNodes) {
+  // Retired towers flow from the reclaimer thread back into the pool while the writers keep allocating
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  epoch.StartReclaimer({std::chrono::milliseconds(1), 4096});
+  OptimisticSkipList<unsigned, PoolAllocator> list(&epoch);
+  int failures = 0;
+  CheckDisjointWriters(list, NO_THREADS, NO_OPS, 10, &failures);
+  epoch.StopReclaimer();
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST(TestUnrolledSortedList, SingleThread) {
+  // Chunks of a few values, so that the inserts split and the deletes merge and unlink chunks
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  UnrolledSortedList<unsigned, 64> list(&epoch);
+  int failures = 0;
+  CheckSingleThread(list, NO_OPS, &failures);
+  ASSERT_EQ(failures, 0);
+
+  std::vector<unsigned> out(NO_OPS);
+  ASSERT_EQ(list.Scan(100, 200, out), 50U);
+  for (auto idx = 0U; idx < 50; idx++) { ASSERT_EQ(out[idx], 101 + 2 * idx); }
+  ASSERT_EQ(list.Scan(0, NO_OPS, {out.data(), 10}), 10U);
+  ASSERT_EQ(out[9], 19U);
+
+  unsigned result;
+  for (unsigned key = 1; key < NO_OPS; key += 2) { ASSERT_TRUE(list.Delete(key)); }
+  ASSERT_FALSE(list.LookUp(1, result));
+  ASSERT_EQ(list.Scan(0, NO_OPS, out), 0U);
+  list.Insert(7);
+  ASSERT_TRUE(list.LookUp(7, result));
+}
+
+UTEST(TestUnrolledSortedList, DisjointWriters) {
+  // Interleaved key ranges: every chunk is shared by all the writers while it splits and merges
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  epoch.StartReclaimer({std::chrono::milliseconds(1), 4096});
+  UnrolledSortedList<unsigned, 64, PoolAllocator> list(&epoch);
+  int failures = 0;
+  CheckDisjointWriters(list, NO_THREADS, NO_OPS, 10, &failures);
+  epoch.StopReclaimer();
+  ASSERT_EQ(failures, 0);
+
+  std::vector<unsigned> expected;
+  for (unsigned key = 0; key < NO_OPS; key++) {
+    if ((key % (2 * NO_THREADS)) >= NO_THREADS) { expected.push_back(key); }
+  }
+  std::vector<unsigned> out(NO_OPS);
+  ASSERT_EQ(list.Scan(0, NO_OPS, out), expected.size());
+  ASSERT_TRUE(std::equal(expected.begin(), expected.end(), out.begin()));
+}
+
+UTEST(TestWorkload, KeyDistributions) {
+  // Rank 0 is the most popular one, and nothing falls outside of the key space
+  ZipfianGenerator zipfian(1000, 0.99);
+  std::mt19937_64 rng(42);
+  std::vector<uint64_t> hits(1000);
+  for (auto idx = 0; idx < 100000; idx++) {
+    auto rank = zipfian.Next(rng);
+    ASSERT_LT(rank, 1000U);
+    hits[rank]++;
+  }
+  EXPECT_EQ(std::max_element(hits.begin(), hits.end()) - hits.begin(), 0);
+  EXPECT_GT(hits[0], hits[999] * 10);
+}
+
+UTEST(TestWorkload, DriveThroughInterface) {
+  auto config        = WorkloadConfig::Preset('e');
+  config.keys        = 256;
+  config.threads     = 2;
+  config.duration_ms = 20;
+
+  MutexSortedList<uint64_t> mutex_list;
+  SortedList<uint64_t> &list = mutex_list;
+  LoadWorkload(list, config);
+  uint64_t result;
+  EXPECT_TRUE(list.LookUp(254, result));
+  EXPECT_FALSE(list.LookUp(255, result));
+  auto workload = RunWorkload(list, config);
+  EXPECT_GT(workload.ops[static_cast<uint32_t>(WorkloadOp::SCAN)], 0U);
+
+  // Scans on a list without Scan() are refused before any worker starts
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  LockCouplingSortedList<uint64_t> coupling_list(&epoch);
+  EXPECT_EXCEPTION(RunWorkload(coupling_list, config), std::logic_error);
+}
+
+UTEST_MAIN();
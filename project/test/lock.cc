@@ -1,4 +1,8 @@
 #include "sync/lock.h"
+#include "sync/guard.h"
+#include "sync/scalable_lock.h"
+#include "common/stats.h"
+#include "common/utils.h"
 #include "common/utest.h"
 
 #include <chrono>
@@ -127,4 +131,224 @@ UTEST(TestHybridLock, HeavyOperation) {
   EXPECT_EQ(counter, NO_THREADS * NO_OPS / 2);
 }
 
+UTEST(TestHybridLock, ParkAndWake) {
+  static constexpr WaitPolicy park_at_once{0, 0, 1, true};
+  HybridLock lock;
+  std::atomic<int> acquired = 0;
+
+  // Readers park behind a writer
+  lock.TryLockExclusive(lock.StateAndVersion().load());
+  std::thread readers[4];
+  for (auto &thread : readers) {
+    thread = std::thread([&]() {
+      HybridGuard guard(&lock, GuardMode::SHARED, park_at_once);
+      acquired++;
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(acquired.load(), 0);
+  EXPECT_TRUE((lock.StateAndVersion().load() & HybridLock::PARKED) != 0);
+  EXPECT_EQ(lock.Version(), 0U);
+  lock.UnlockExclusive();
+  for (auto &thread : readers) { thread.join(); }
+  EXPECT_EQ(acquired.load(), 4);
+  EXPECT_EQ(lock.StateAndVersion().load() & HybridLock::PARKED, 0U);
+  EXPECT_EQ(lock.Version(), 1U);
+
+  // A writer parks behind two readers, only the last one wakes it up
+  lock.TryLockShared(lock.StateAndVersion().load());
+  lock.TryLockShared(lock.StateAndVersion().load());
+  std::thread writer([&]() {
+    HybridGuard guard(&lock, GuardMode::EXCLUSIVE, park_at_once);
+    acquired++;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  lock.UnlockShared();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(acquired.load(), 4);
+  lock.UnlockShared();
+  writer.join();
+  EXPECT_EQ(acquired.load(), 5);
+  EXPECT_EQ(lock.StateAndVersion().load(), 2U);
+}
+
+UTEST(TestHybridLock, OverlappingReaders) {
+  static constexpr WaitPolicy park_at_once{0, 0, 1, true};
+  HybridLock lock;
+  std::atomic<int> acquired = 0;
+
+  // The lock never drops to zero readers: the newcomers start at MAX_SHARED and must not park
+  for (auto idx = 0U; idx < HybridLock::MAX_SHARED; idx++) {
+    EXPECT_TRUE(lock.TryLockShared(lock.StateAndVersion().load()));
+  }
+  std::thread readers[NO_THREADS / 10];
+  for (auto &thread : readers) {
+    thread = std::thread([&]() {
+      for (auto idx = 0; idx < NO_OPS / 10; idx++) {
+        HybridGuard guard(&lock, GuardMode::SHARED, park_at_once);
+        acquired++;
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(acquired.load(), 0);
+  lock.UnlockShared();
+  for (auto wait = 0; wait < 2000 && acquired.load() < NO_THREADS * NO_OPS / 100; wait++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(acquired.load(), NO_THREADS * NO_OPS / 100);
+  EXPECT_EQ(lock.StateAndVersion().load() & HybridLock::PARKED, 0U);
+
+  // Release the rest, which also wakes up anybody who parked anyway
+  for (auto idx = 1U; idx < HybridLock::MAX_SHARED; idx++) { lock.UnlockShared(); }
+  for (auto &thread : readers) { thread.join(); }
+  EXPECT_EQ(lock.LockState(), HybridLock::UNLOCKED);
+}
+
+UTEST(TestScalableHybridLock, SerializeOperation) {
+  ScalableHybridLock lock;
+
+  // Exclusive Latch then all subsequent latch attempts should fail
+  EXPECT_TRUE(lock.TryLockExclusive(lock.StateAndVersion().load()));
+  for (auto idx = 0; idx < 5; idx++) { EXPECT_FALSE(lock.TryLockShared(lock.StateAndVersion())); }
+  EXPECT_FALSE(lock.TryLockExclusive(lock.StateAndVersion()));
+  EXPECT_EQ(lock.Readers(), 0U);
+  lock.UnlockExclusive();
+  EXPECT_EQ(lock.Version(), 1U);
+
+  // No MAX_SHARED limit, and shared latches never touch the version
+  for (size_t idx = 0; idx < 4 * HybridLock::MAX_SHARED; idx++) {
+    EXPECT_TRUE(lock.TryLockShared(lock.StateAndVersion()));
+  }
+  EXPECT_EQ(lock.Readers(), 4 * HybridLock::MAX_SHARED);
+  EXPECT_EQ(lock.LockState(), ScalableHybridLock::UNLOCKED);
+  for (size_t idx = 0; idx < 4 * HybridLock::MAX_SHARED; idx++) { lock.UnlockShared(); }
+  EXPECT_EQ(lock.Readers(), 0U);
+  EXPECT_EQ(lock.Version(), 1U);
+}
+
+UTEST(TestScalableHybridLock, UpgradeDowngradeLock) {
+  ScalableHybridLock lock;
+  EXPECT_TRUE(lock.TryLockShared(lock.StateAndVersion()));
+  EXPECT_TRUE(lock.UpgradeLock(lock.StateAndVersion()));
+  EXPECT_EQ(lock.Readers(), 0U);
+  EXPECT_FALSE(lock.TryLockShared(lock.StateAndVersion()));
+  lock.DowngradeLock();
+  EXPECT_EQ(lock.Readers(), 1U);
+  EXPECT_EQ(lock.Version(), 1U);
+  EXPECT_TRUE(lock.TryLockShared(lock.StateAndVersion()));
+  lock.UnlockShared();
+  lock.UnlockShared();
+}
+
+UTEST(TestScalableHybridLock, NormalOperation) {
+  // Same mix as TestHybridLock.HeavyOperation, through the guard
+  int counter = 0;
+  ScalableHybridLock lock;
+
+  std::thread threads[NO_THREADS];
+  for (int idx = 0; idx < NO_THREADS; idx++) {
+    if (idx % 2 == 0) {
+      threads[idx] = std::thread([&]() {
+        for (auto op = 0; op < NO_OPS; op++) {
+          ScalableHybridGuard guard(&lock, GuardMode::EXCLUSIVE);
+          counter++;
+        }
+      });
+    } else {
+      threads[idx] = std::thread([&]() {
+        for (auto op = 0; op < NO_OPS; op++) {
+          ScalableHybridGuard guard(&lock, GuardMode::SHARED);
+          auto before = counter;
+          std::this_thread::yield();
+          EXPECT_EQ(before, counter);
+        }
+      });
+    }
+  }
+  for (auto &thread : threads) { thread.join(); }
+
+  EXPECT_EQ(counter, NO_THREADS * NO_OPS / 2);
+  EXPECT_EQ(lock.Version(), uint64_t{NO_THREADS * NO_OPS / 2});
+}
+
+UTEST(TestRestartTracker, AdaptiveBudget) {
+  RestartTracker fixed(RestartPolicy{4, false});
+  for (auto op = 0; op < 100; op++) { fixed.Record(10); }
+  EXPECT_EQ(fixed.Budget(), 4U);
+
+  // Frequent restarts shrink the budget to a single attempt, a calm period restores it
+  RestartTracker adaptive(RestartPolicy::Default());
+  EXPECT_EQ(adaptive.Budget(), RestartPolicy::Default().max_optimistic_attempts);
+  for (auto op = 0; op < 100; op++) { adaptive.Record(10); }
+  EXPECT_EQ(adaptive.Budget(), 1U);
+  for (auto op = 0U; op < 100 * RestartTracker::SAMPLE_PERIOD; op++) { adaptive.Record(0); }
+  EXPECT_EQ(adaptive.Budget(), RestartPolicy::Default().max_optimistic_attempts);
+
+  // Each tracker samples its own restart-free operations, a calm neighbour does not decay a busy one
+  RestartTracker busy(RestartPolicy::Default());
+  RestartTracker calm(RestartPolicy::Default());
+  for (auto op = 0; op < 100; op++) { busy.Record(10); }
+  for (auto op = 0U; op < 100 * RestartTracker::SAMPLE_PERIOD; op++) { calm.Record(0); }
+  for (auto op = 1U; op < RestartTracker::SAMPLE_PERIOD; op++) { busy.Record(0); }
+  EXPECT_EQ(busy.Budget(), 1U);
+}
+
+UTEST(TestStats, GuardCounters) {
+  HybridLock lock;
+  auto before = Stats::Snapshot();
+  {
+    HybridGuard guard(&lock, GuardMode::OPTIMISTIC);
+    EXPECT_TRUE(lock.TryLockExclusive(lock.StateAndVersion().load()));
+    lock.UnlockExclusive();
+    EXPECT_FALSE(guard.TryValidateOptimisticLock());
+  }
+  { HybridGuard guard(&lock, GuardMode::SHARED); }
+
+  // A contended acquisition from a thread which exits before the snapshot
+  EXPECT_TRUE(lock.TryLockExclusive(lock.StateAndVersion().load()));
+  std::thread writer([&]() { HybridGuard guard(&lock, GuardMode::EXCLUSIVE); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  lock.UnlockExclusive();
+  writer.join();
+
+  auto delta = Stats::Snapshot() - before;
+  if constexpr (STATS_ENABLED) {
+    EXPECT_EQ(delta[Counter::OPTIMISTIC_ATTEMPTS], 1);
+    EXPECT_EQ(delta[Counter::VALIDATION_FAILURES], 1);
+    EXPECT_EQ(delta[Counter::SHARED_ACQUISITIONS], 1);
+    EXPECT_EQ(delta[Counter::EXCLUSIVE_ACQUISITIONS], 1);
+    EXPECT_GT(delta[Counter::SPIN_ITERATIONS], 0);
+    EXPECT_GT(delta[Counter::WAIT_NS], 0);
+    EXPECT_EQ(delta[Timer::OPTIMISTIC_GUARD].Count(), 1);
+    EXPECT_EQ(delta[Timer::SHARED_GUARD].Count(), 1);
+    EXPECT_EQ(delta[Timer::EXCLUSIVE_GUARD].Count(), 1);
+    // The writer waited for the 1ms sleep
+    EXPECT_GT(delta[Timer::EXCLUSIVE_GUARD].Max(), 500000);
+  } else {
+    for (auto value : delta.values) { EXPECT_EQ(value, 0U); }
+    for (auto &histogram : delta.latencies) { EXPECT_EQ(histogram.Count(), 0U); }
+  }
+}
+
+UTEST(TestLatencyHistogram, Percentiles) {
+  // Small values are exact, larger ones are within 1/SUB_BUCKETS of the real value
+  for (auto value : {0UL, 1UL, 63UL, 64UL, 1000UL, 123456789UL, ~0UL}) {
+    auto bound = LatencyHistogram::UpperBound(LatencyHistogram::BucketOf(value));
+    EXPECT_GE(bound, value);
+    EXPECT_LE(bound - value, value / LatencyHistogram::SUB_BUCKETS);
+  }
+
+  LatencyHistogram first;
+  LatencyHistogram second;
+  for (auto value = 1UL; value <= 1000; value++) { ((value & 1) ? first : second).Record(value); }
+  second.Record(1000000);
+  first.Merge(second);
+  EXPECT_EQ(first.Count(), 1001U);
+  EXPECT_EQ(first.Max(), 1000000U);
+  EXPECT_NEAR(first.Percentile(0.5), 500, 500 / LatencyHistogram::SUB_BUCKETS);
+  EXPECT_NEAR(first.Percentile(0.99), 990, 990 / LatencyHistogram::SUB_BUCKETS);
+  EXPECT_EQ(first.Percentile(1), 1000000U);
+}
+
 UTEST_MAIN();
@@ -1,5 +1,8 @@
 #include "common/utest.h"
+#include "common/perf_event.h"
+#include "common/utils.h"
 #include "list/list.h"
+#include "../src/list/list.cc"
 #include <algorithm>
 #include <chrono>
 #include <iostream>
@@ -7,7 +10,6 @@
 #include <random>
 #include <thread>
 #include <algorithm>
-#include "PerfEvent.hpp"
 #include <chrono>
 #include <cstdint>
 #include <cstddef> 
@@ -62,7 +64,7 @@ UTEST(TestMutexSortedList, LookUp){
   }
   
   PerfEvent e;
-  e.startCounters();
+  e.StartCounters();
   for (auto idx = 0; idx < NO_THREADS; idx++) {
     threads[idx] = std::thread([&, tid = idx]() {
       Student value;
@@ -74,8 +76,8 @@ UTEST(TestMutexSortedList, LookUp){
   }
 
   for (auto &thread : threads) { thread.join(); }
-  e.stopCounters();
-  e.printReport(std::cout, NO_THREADS);
+  e.StopCounters();
+  e.PrintReport(std::cout, NO_THREADS);
 }
 
 UTEST(TestOptimisticSortedList, LookUp){
@@ -91,7 +93,7 @@ UTEST(TestOptimisticSortedList, LookUp){
   }
   
   PerfEvent e;
-  e.startCounters();
+  e.StartCounters();
   for (auto idx = 0; idx < NO_THREADS; idx++) {
     threads[idx] = std::thread([&, tid = idx]() {
       InitializeThread();
@@ -104,8 +106,8 @@ UTEST(TestOptimisticSortedList, LookUp){
   }
 
   for (auto &thread : threads) { thread.join(); }
-  e.stopCounters();
-  e.printReport(std::cout, NO_THREADS);
+  e.StopCounters();
+  e.PrintReport(std::cout, NO_THREADS);
 }
 
 UTEST_MAIN();
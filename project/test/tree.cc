@@ -0,0 +1,106 @@
+#include "common/utest.h"
+#include "common/simd.h"
+#include "common/utils.h"
+#include "tree/btree.h"
+#include "../src/tree/btree.cc"
+#include "checks.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+static constexpr int NO_THREADS     = 8;
+static constexpr int NO_OPS         = 10000;
+static constexpr uint64_t SMALL_NODE = 128;  // a few entries per node, to exercise splits
+
+using namespace FinalProject;
+
+UTEST(TestOptimisticBTree, SingleThread) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticBTree<unsigned, SMALL_NODE> tree(&epoch);
+  int failures = 0;
+  CheckSingleThread(tree, NO_OPS, &failures);
+  ASSERT_EQ(failures, 0);
+
+  // Empty whole leaves, they are unlinked and their key ranges must stay reachable
+  unsigned result;
+  for (unsigned key = 1; key < NO_OPS / 2; key += 2) { ASSERT_TRUE(tree.Delete(key)); }
+  for (unsigned key = 0; key < NO_OPS; key++) { ASSERT_EQ(tree.LookUp(key, result), key % 2 == 1 && key > NO_OPS / 2); }
+  for (unsigned key = 0; key < NO_OPS / 2; key++) { tree.Insert(key); }
+  for (unsigned key = 0; key < NO_OPS / 2; key++) { ASSERT_TRUE(tree.LookUp(key, result)); }
+}
+
+UTEST(TestOptimisticBTree, DisjointWriters) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticBTree<unsigned, SMALL_NODE> tree(&epoch);
+  int failures = 0;
+  CheckDisjointWriters(tree, NO_THREADS, NO_OPS, 0, &failures);
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST(TestOptimisticBTree, ReadersAndWriters) {
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticBTree<unsigned, SMALL_NODE> tree(&epoch);
+  int failures = 0;
+  CheckReadersAndWriters(tree, NO_THREADS, NO_OPS, 2, &failures);
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST(TestOptimisticBTree, ReadersDuringSplits) {
+  // Even keys are loaded up front and never touched again, odd keys are inserted concurrently
+  EpochHandler epoch(EpochHandler::MAX_NUMBER_OF_WORKER);
+  OptimisticBTree<unsigned, SMALL_NODE> tree(&epoch);
+  for (unsigned key = 0; key < NO_OPS; key += 2) { tree.Insert(key); }
+
+  std::thread threads[NO_THREADS];
+  for (auto idx = 0; idx < NO_THREADS; idx++) {
+    threads[idx] = std::thread([&, tid = idx]() {
+      InitializeThread();
+      unsigned result;
+      if (tid % 2 == 0) {
+        for (unsigned key = tid + 1; key < NO_OPS; key += NO_THREADS) { tree.Insert(key); }
+      } else {
+        for (unsigned key = 0; key < NO_OPS; key += 2) { EXPECT_TRUE(tree.LookUp(key, result)); }
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+
+  unsigned result;
+  for (unsigned key = 0; key < NO_OPS; key += 2) { ASSERT_TRUE(tree.LookUp(key, result)); }
+}
+
+/* Compare KeyLowerBound() with std::lower_bound, around every key and past both ends */
+template <typename K>
+void CheckKeySearch(int *failures) {
+  std::mt19937_64 rng(42);
+  for (uint32_t count = 0; count <= 300; count += (count < 40) ? 1 : 37) {
+    std::vector<K> keys(count);
+    for (auto &key : keys) { key = static_cast<K>(rng()); }
+    std::sort(keys.begin(), keys.end());
+    std::vector<K> probes = {std::numeric_limits<K>::min(), std::numeric_limits<K>::max(), 0};
+    for (auto key : keys) {
+      probes.insert(probes.end(), {key, static_cast<K>(key - 1), static_cast<K>(key + 1)});
+    }
+    for (auto probe : probes) {
+      auto expected = std::lower_bound(keys.begin(), keys.end(), probe) - keys.begin();
+      if (KeyLowerBound(keys.data(), count, probe) != expected) { (*failures)++; }
+    }
+  }
+}
+
+UTEST(TestKeySearch, MatchesScalar) {
+  int failures = 0;
+  CheckKeySearch<int32_t>(&failures);
+  CheckKeySearch<uint32_t>(&failures);
+  CheckKeySearch<int64_t>(&failures);
+  CheckKeySearch<uint64_t>(&failures);
+  CheckKeySearch<int16_t>(&failures);  // Scalar fallback
+  ASSERT_EQ(failures, 0);
+}
+
+UTEST_MAIN();